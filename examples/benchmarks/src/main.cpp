@@ -0,0 +1,831 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <iostream>
+#include <ctime>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <cmath>
+
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralBatchEvaluator.h"
+#include "SimpleNeuralRandom.h"
+#include "SimpleNeuralDeltaEvaluator.h"
+#include "SimpleNeuralIslands.h"
+#include "SimpleNeuralSteadyState.h"
+#include "SimpleNeuralGradientTrainer.h"
+#include "SimpleNeuralLeastSquares.h"
+#include "SimpleNeuralCmaEs.h"
+#include "SimpleNeuralEvolutionStrategies.h"
+#include "SimpleNeuralPruner.h"
+#include "SimpleNeuralGramEvaluator.h"
+#include "SimpleNeuralThreadPool.h"
+#include "CalcTangentSimpleNeuralNetwork.h"
+
+// Benchmarks on the data of car_learning example.
+// Run from the root of repository: ./example_benchmarks [name of benchmark]
+
+void initCarLearningTrainingData(SimpleNeuralTrainingItemList &trainingData) {
+    std::string sFilename = "examples/car_learning/data.txt";
+    std::cout << "Read training data from " << sFilename << std::endl;
+    std::ifstream data;
+    data.open(sFilename.c_str(), std::ios_base::in);  // open data
+    for (std::string sLine; std::getline(data, sLine); ) {
+        std::istringstream iLine(sLine);      //make a stream for the line itself
+        std::vector<float> vIn;
+        for (int i = 0; i < 25; i++) {
+            float x;
+            iLine >> x;
+            vIn.push_back(x);
+        }
+        float out1;
+        iLine >> out1;
+        float out2;
+        iLine >> out2;
+        trainingData.addItem(vIn, {out1, out2});
+    }
+    std::cout << "Data for training: " << trainingData.size() << std::endl;
+}
+
+// the same data as in mesh_calc_tangents example: the point with points of its triangles -> tangent
+void initMeshTrainingData(SimpleNeuralTrainingItemList &trainingData) {
+    std::string sFilename = "examples/mesh_calc_tangents/data.txt";
+    std::cout << "Read training data from " << sFilename << std::endl;
+    std::ifstream data;
+    data.open(sFilename.c_str(), std::ios_base::in);
+    std::vector<SimpleNeuralNetworkMeshPoint> vPoints;
+    std::vector<std::vector<float>> vTangents;
+    for (std::string sLine; std::getline(data, sLine); ) {
+        std::istringstream iLine(sLine);
+        float nX, nY, nZ;
+        iLine >> nX >> nY >> nZ;
+        vPoints.push_back(SimpleNeuralNetworkMeshPoint(nX, nY, nZ));
+        std::vector<float> vTangent(4);
+        iLine >> vTangent[0] >> vTangent[1] >> vTangent[2] >> vTangent[3];
+        vTangents.push_back(vTangent);
+    }
+    for (int i = 0; i < vPoints.size(); i++) {
+        std::vector<SimpleNeuralNetworkMeshPoint> vPointsIn;
+        vPointsIn.push_back(vPoints[i]);
+        std::vector<int> vTriangles;
+        for (int j = 0; j < vPoints.size(); j++) {
+            if (vPoints[i].isEqual(vPoints[j]) && std::find(vTriangles.begin(), vTriangles.end(), j / 3) == vTriangles.end()) {
+                vTriangles.push_back(j / 3);
+            }
+        }
+        for (int t = 0; t < vTriangles.size(); t++) {
+            for (int k = 0; k < 3; k++) {
+                vPointsIn.push_back(vPoints[vTriangles[t] * 3 + k]);
+            }
+        }
+        trainingData.addItem(toVector(normalizeNumPoints(vPointsIn)), vTangents[i]);
+    }
+    std::cout << "Data for training: " << trainingData.size() << std::endl;
+}
+
+double elapsedSeconds(std::chrono::steady_clock::time_point start) {
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000000.0;
+}
+
+void benchmarkBatchEvaluator(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- batch evaluator ------- " << std::endl;
+    SimpleNeuralNetwork net({trainingData.getNumberOfIn(), 64, 128, 64, trainingData.getNumberOfOut()});
+    SimpleNeuralGenomList genoms(30, 40, 40);
+    genoms.fillRandom(&net);
+    SimpleNeuralBatchEvaluator evaluator(&net, &trainingData);
+
+    constexpr int nGenerations = 3;
+    long long nGenomSamples = (long long)nGenerations * 80 * trainingData.size();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < nGenerations; ++i) {
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+    }
+    double nLoopSeconds = elapsedSeconds(start);
+    float nLoopRating = genoms.list().back().getRating();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < nGenerations; ++i) {
+        genoms.calculateRatingForMutatedAndMixed(&evaluator);
+    }
+    double nBatchSeconds = elapsedSeconds(start);
+    float nBatchRating = genoms.list().back().getRating();
+
+    std::cout
+        << "calculateRatingForMutatedAndMixed (loop):  " << (nGenomSamples / nLoopSeconds) << " genom-samples/s" << std::endl
+        << "calculateRatingForMutatedAndMixed (batch): " << (nGenomSamples / nBatchSeconds) << " genom-samples/s" << std::endl
+        << "speedup: " << (nLoopSeconds / nBatchSeconds) << "x" << std::endl
+        << "same rating: " << (nLoopRating == nBatchRating ? "yes" : "no") << std::endl
+    ;
+}
+
+// the operator before bulk kernels: one std::rand() per mutated weight
+void mutateGenomPointwise(std::vector<float> &vWeights) {
+    int nCountOfMutations = std::rand() % vWeights.size();
+    for (int i = 0; i < nCountOfMutations; i++) {
+        int n = std::rand() % vWeights.size();
+        float nSign = float((std::rand() % 2) * 2 - 1);
+        vWeights[n] = vWeights[n] + nSign * vWeights[n] * 0.01f;
+    }
+}
+
+void benchmarkOffspring(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- offspring (genom with ~1M weights) ------- " << std::endl;
+    SimpleNeuralNetwork net({trainingData.getNumberOfIn(), 1000, 1000, trainingData.getNumberOfOut()});
+    int nSize = net.getGenomSize();
+    std::vector<float> vParent0 = net.getGenom();
+    std::vector<float> vParent1 = net.getGenom();
+    std::vector<float> vChild(nSize);
+    SimpleNeuralRandom random(1);
+    constexpr int nRepeats = 20;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < nRepeats; ++i) {
+        mutateGenomPointwise(vParent1);
+    }
+    double nPointwise = elapsedSeconds(start) / nRepeats;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < nRepeats; ++i) {
+        net.mutateGenom(vParent1.data(), random);
+    }
+    double nBulk = elapsedSeconds(start) / nRepeats;
+
+    std::vector<std::pair<std::string, SimpleNeuralCrossover>> vCrossovers = {
+        {"uniform", SimpleNeuralCrossover::Uniform},
+        {"layers", SimpleNeuralCrossover::Layers},
+        {"neurons", SimpleNeuralCrossover::Neurons},
+    };
+    std::cout
+        << "mutation (pointwise std::rand): " << nPointwise * 1000.0 << "ms" << std::endl
+        << "mutation (bulk mask): " << nBulk * 1000.0 << "ms" << std::endl
+    ;
+    for (int c = 0; c < vCrossovers.size(); ++c) {
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nRepeats; ++i) {
+            net.mixGenom(vParent0.data(), vParent1.data(), vChild.data(), random, vCrossovers[c].second);
+        }
+        std::cout << "crossover (" << vCrossovers[c].first << "): " << elapsedSeconds(start) / nRepeats * 1000.0 << "ms" << std::endl;
+    }
+
+    // compare with rating of this genom on the training data
+    start = std::chrono::steady_clock::now();
+    for (auto it = trainingData.begin(); it != trainingData.end(); ++it) {
+        net.calc(vChild.data(), it->getIn());
+    }
+    std::cout << "one rating on training data: " << elapsedSeconds(start) * 1000.0 << "ms" << std::endl;
+}
+
+void benchmarkDeltaEvaluator(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- delta evaluator (light mutation: 10 weights +-1%) ------- " << std::endl;
+    SimpleNeuralNetwork net({trainingData.getNumberOfIn(), 64, 128, 64, trainingData.getNumberOfOut()});
+    int nSize = net.getGenomSize();
+    constexpr int nParents = 30;
+    constexpr int nChildren = 80;
+    std::vector<float> vParents(nParents * nSize);
+    std::vector<float> vChildren(nChildren * nSize);
+    SimpleNeuralRandom random(7);
+    std::vector<const float *> vParentOfChild;
+    std::vector<SimpleNeuralGenom> vGenoms;
+    for (int i = 0; i < nParents; ++i) {
+        std::copy(net.getGenom().begin(), net.getGenom().end(), vParents.begin() + i * nSize);
+        net.mutateGenom(vParents.data() + i * nSize, random);
+    }
+    for (int i = 0; i < nChildren; ++i) {
+        const float *pParent = vParents.data() + random.nextInt(nParents) * nSize;
+        float *pChild = vChildren.data() + i * nSize;
+        std::copy(pParent, pParent + nSize, pChild);
+        for (int m = 0; m < 10; ++m) {
+            int n = random.nextInt(nSize);
+            pChild[n] += (random.nextInt(2) == 0 ? -0.01f : 0.01f) * pChild[n];
+        }
+        vParentOfChild.push_back(pParent);
+        vGenoms.emplace_back(pChild, nSize, 0.0f);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<float> vFullRatings;
+    for (int i = 0; i < nChildren; ++i) {
+        vGenoms[i].calculateRating(&net, &trainingData);
+        vFullRatings.push_back(vGenoms[i].getRating());
+    }
+    double nFullSeconds = elapsedSeconds(start);
+
+    SimpleNeuralDeltaEvaluator evaluator(&net, &trainingData);
+    std::vector<const float *> vAllParents;
+    for (int i = 0; i < nParents; ++i) {
+        vAllParents.push_back(vParents.data() + i * nSize);
+    }
+    start = std::chrono::steady_clock::now();
+    evaluator.setParents(vAllParents);
+    for (int i = 0; i < nParents; ++i) {
+        evaluator.prepareParent(i);
+    }
+    double nCacheSeconds = elapsedSeconds(start);
+
+    start = std::chrono::steady_clock::now();
+    float nMaxDiff = 0.0f;
+    for (int i = 0; i < nChildren; ++i) {
+        evaluator.calculateRating(vGenoms[i], vParentOfChild[i]);
+        nMaxDiff = std::max(nMaxDiff, std::abs(vGenoms[i].getRating() - vFullRatings[i]) / std::max(1.0f, vFullRatings[i]));
+    }
+    double nDeltaSeconds = elapsedSeconds(start);
+
+    std::cout
+        << "full rating of " << nChildren << " children: " << nFullSeconds * 1000.0 << "ms" << std::endl
+        << "cache of " << nParents << " parents (once per elite): " << nCacheSeconds * 1000.0 << "ms" << std::endl
+        << "delta rating of " << nChildren << " children: " << nDeltaSeconds * 1000.0 << "ms" << std::endl
+        << "speedup (children only): " << nFullSeconds / nDeltaSeconds << "x" << std::endl
+        << "max relative difference of rating: " << nMaxDiff << std::endl
+    ;
+}
+
+void benchmarkIslands(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- islands ------- " << std::endl;
+    // the same number of genoms and generations: one population rated in parallel
+    // against islands, which are synchronized only for migrations
+    constexpr int nIslands = 4;
+    constexpr int nGenerations = 20;
+    SimpleNeuralNetwork net({trainingData.getNumberOfIn(), 16, 16, trainingData.getNumberOfOut()});
+
+    SimpleNeuralGenomList genoms(nIslands * 5, nIslands * 10, nIslands * 10);
+    genoms.setNumberOfThreads(0);
+    genoms.setRandomSeed(1);
+    genoms.fillRandom(&net);
+    auto start = std::chrono::steady_clock::now();
+    genoms.calculateRatingForAll(&net, &trainingData);
+    for (int n = 0; n < nGenerations; ++n) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+    }
+    double nPopulationSeconds = elapsedSeconds(start);
+
+    SimpleNeuralIslands islands(nIslands, 5, 10, 10);
+    islands.setRandomSeed(1);
+    islands.setMigration(SimpleNeuralMigration::Ring, 5, 2);
+    islands.fillRandom(&net);
+    start = std::chrono::steady_clock::now();
+    islands.calculateRatingForAll(&net, &trainingData);
+    islands.evolve(&net, &trainingData, nGenerations);
+    double nIslandsSeconds = elapsedSeconds(start);
+
+    std::cout << "threads: " << islands.getNumberOfThreads() << std::endl;
+    std::cout << "one population: " << nPopulationSeconds << "s, better rating " << genoms.getBetterRating() << std::endl;
+    std::cout << nIslands << " islands: " << nIslandsSeconds << "s, better rating " << islands.getBetterRating()
+        << ", migrants " << islands.getNumberOfMigrants() << std::endl;
+    std::cout << "speedup: " << nPopulationSeconds / nIslandsSeconds << "x" << std::endl;
+}
+
+void benchmarkSteadyState(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- steady state ------- " << std::endl;
+    // the same number of children: generational loop against steady-state without barriers,
+    // utilization is the working time of threads to the wall time of all threads
+    constexpr int nGenerations = 10;
+    constexpr int nChildren = 80;
+    SimpleNeuralNetwork net({trainingData.getNumberOfIn(), 32, 32, trainingData.getNumberOfOut()});
+
+    SimpleNeuralGenomList genoms(30, 40, 40);
+    genoms.setNumberOfThreads(0);
+    genoms.setRandomSeed(1);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &trainingData);
+    double nBusyBefore = genoms.getBusySeconds();
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < nGenerations; ++n) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+    }
+    double nGenerationalSeconds = elapsedSeconds(start);
+    double nGenerationalBusy = genoms.getBusySeconds() - nBusyBefore;
+
+    SimpleNeuralSteadyState steady(30);
+    steady.setRandomSeed(1);
+    steady.fillRandom(&net);
+    steady.calculateRatingForAll(&net, &trainingData);
+    nBusyBefore = steady.getBusySeconds();
+    start = std::chrono::steady_clock::now();
+    steady.evolve(&net, &trainingData, nGenerations * nChildren);
+    steady.stop(); // the workers go on after evolve(), the busy time is counted by the end of their tasks
+    double nSteadySeconds = elapsedSeconds(start);
+    double nSteadyBusy = steady.getBusySeconds() - nBusyBefore;
+
+    int nThreads = genoms.getNumberOfThreads();
+    std::cout << "threads: " << nThreads << ", children: " << nGenerations * nChildren
+        << " (steady state: " << steady.getNumberOfChildren() << ")" << std::endl;
+    if (nThreads == 1) {
+        std::cout << "(one thread: utilization is not measured in the serial generational loop)" << std::endl;
+    }
+    std::cout << "generational: " << nGenerationalSeconds << "s, utilization "
+        << int(100.0 * nGenerationalBusy / (nGenerationalSeconds * nThreads)) << "%, better rating " << genoms.getBetterRating() << std::endl;
+    std::cout << "steady state: " << nSteadySeconds << "s, utilization "
+        << int(100.0 * nSteadyBusy / (nSteadySeconds * nThreads)) << "%, better rating " << steady.getBetterRating()
+        << ", accepted " << steady.getNumberOfAccepted() << std::endl;
+}
+
+void benchmarkGradientTrainer(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- gradient trainer ------- " << std::endl;
+    // the same time for the genetic algorithm and for Adam from the same start
+    constexpr double nSeconds = 20.0;
+    SimpleNeuralNetwork net({trainingData.getNumberOfIn(), 64, 128, 64, trainingData.getNumberOfOut()});
+
+    SimpleNeuralGenomList genoms(30, 40, 40);
+    genoms.setNumberOfThreads(0);
+    genoms.setRandomSeed(1);
+    genoms.fillRandom(&net);
+    auto start = std::chrono::steady_clock::now();
+    genoms.calculateRatingForAll(&net, &trainingData);
+    int nGenerations = 0;
+    while (elapsedSeconds(start) < nSeconds) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+        ++nGenerations;
+    }
+    std::cout << "genetic: " << nGenerations << " generations, better rating " << genoms.getBetterRating() << std::endl;
+
+    SimpleNeuralGradientTrainer trainer(&net, &trainingData);
+    trainer.setRandomSeed(1);
+    std::vector<float> vWeights = net.getGenom();
+    SimpleNeuralGenom genom(vWeights.data(), vWeights.size(), 0.0f);
+    start = std::chrono::steady_clock::now();
+    int nEpochs = 0;
+    while (elapsedSeconds(start) < nSeconds) {
+        trainer.trainEpoch(vWeights.data());
+        ++nEpochs;
+    }
+    genom.calculateRating(&net, &trainingData);
+    std::cout << "adam: " << nEpochs << " epochs, rating " << genom.getRating() << std::endl;
+}
+
+float runGenetic(SimpleNeuralNetwork &net, SimpleNeuralTrainingItemList &trainingData, int nGenerations, const SimpleNeuralGenom *pSeed = nullptr) {
+    SimpleNeuralGenomList genoms(30, 40, 40);
+    genoms.setNumberOfThreads(0);
+    genoms.setRandomSeed(1);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &trainingData);
+    if (pSeed != nullptr) {
+        genoms.replaceWorstGenom(pSeed->getWeights(), pSeed->getRating());
+    }
+    for (int n = 0; n < nGenerations; ++n) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+    }
+    return genoms.getBetterRating();
+}
+
+void benchmarkLeastSquaresOn(SimpleNeuralNetwork &net, SimpleNeuralTrainingItemList &trainingData, int nGenerations) {
+    std::vector<float> vRandomStart = net.getGenom();
+    auto start = std::chrono::steady_clock::now();
+    float nGeneticRating = runGenetic(net, trainingData, nGenerations);
+    std::cout << "genetic: " << nGenerations << " generations, " << elapsedSeconds(start)
+        << "s, better rating " << nGeneticRating << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    SimpleNeuralLeastSquares solver(&net);
+    solver.accumulate(&trainingData);
+    solver.solve();
+    std::vector<float> vGenom = solver.getGenom();
+    double nSolveSeconds = elapsedSeconds(start);
+    SimpleNeuralGenom genom(vGenom.data(), vGenom.size(), 0.0f);
+    genom.calculateRating(&net, &trainingData);
+    std::cout << "least squares: " << nSolveSeconds << "s, rating " << genom.getRating() << std::endl;
+
+    // the solution and its mutations are the start of the genetic algorithm
+    net.setGenom(vGenom);
+    start = std::chrono::steady_clock::now();
+    float nSeededRating = runGenetic(net, trainingData, 3, &genom);
+    std::cout << "genetic from least squares: 3 generations, " << elapsedSeconds(start)
+        << "s, better rating " << nSeededRating << std::endl;
+    net.setGenom(vRandomStart);
+}
+
+void benchmarkLeastSquares(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- least squares ------- " << std::endl;
+    // the data of sum_numbers example
+    SimpleNeuralTrainingItemList sumData(2, 1);
+    for (int i = 0; i < 1000; ++i) {
+        float in0 = static_cast<float>(std::rand() % 100);
+        float in1 = static_cast<float>(std::rand() % 100);
+        sumData.addItem({in0, in1}, {in0 + in1});
+    }
+    std::cout << "sum_numbers:" << std::endl;
+    SimpleNeuralNetwork sumNet({2, 64, 64, 1});
+    benchmarkLeastSquaresOn(sumNet, sumData, 100);
+
+    std::cout << "car_learning:" << std::endl;
+    SimpleNeuralNetwork carNet({trainingData.getNumberOfIn(), 64, 128, 64, trainingData.getNumberOfOut()});
+    benchmarkLeastSquaresOn(carNet, trainingData, 5);
+}
+
+void benchmarkCmaEs(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- cma-es ------- " << std::endl;
+    // time to the target rating with the same number of threads (or the rating at the time limit)
+    constexpr float nTarget = 20000.0f;
+    constexpr double nLimitSeconds = 60.0;
+    SimpleNeuralNetwork net({trainingData.getNumberOfIn(), 64, 128, 64, trainingData.getNumberOfOut()});
+
+    SimpleNeuralGenomList genoms(30, 40, 40);
+    genoms.setNumberOfThreads(0);
+    genoms.setRandomSeed(1);
+    genoms.fillRandom(&net);
+    auto start = std::chrono::steady_clock::now();
+    genoms.calculateRatingForAll(&net, &trainingData);
+    int nGenerations = 0;
+    while (genoms.getBetterRating() > nTarget && elapsedSeconds(start) < nLimitSeconds) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+        ++nGenerations;
+    }
+    std::cout << "threads: " << genoms.getNumberOfThreads() << ", target rating " << nTarget << std::endl;
+    std::cout << "genetic: " << elapsedSeconds(start) << "s, " << nGenerations << " generations, better rating "
+        << genoms.getBetterRating() << std::endl;
+
+    SimpleNeuralCmaEs cma(&net);
+    cma.setNumberOfThreads(0);
+    cma.setRandomSeed(1);
+    start = std::chrono::steady_clock::now();
+    while (cma.getBetterRating() > nTarget && elapsedSeconds(start) < nLimitSeconds) {
+        cma.step(&trainingData);
+    }
+    std::cout << "sep-cma-es: " << elapsedSeconds(start) << "s, " << cma.getGeneration() << " generations of "
+        << cma.getPopulation() << ", better rating " << cma.getBetterRating() << std::endl;
+}
+
+void benchmarkEvolutionStrategies(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- evolution strategies ------- " << std::endl;
+    constexpr int nPairs = 50;
+    constexpr double nLimitSeconds = 20.0;
+    SimpleNeuralNetwork net({trainingData.getNumberOfIn(), 64, 128, 64, trainingData.getNumberOfOut()});
+    std::vector<float> vStart = net.getGenom();
+    SimpleNeuralGenom start(vStart.data(), vStart.size(), 0.0f);
+    start.calculateRating(&net, &trainingData);
+    std::cout << "genom size: " << net.getGenomSize() << ", start rating " << start.getRating() << std::endl;
+
+    // the traffic of one generation, if the workers send ratings or genoms of samples
+    std::cout << "traffic of generation: " << 2 * nPairs * sizeof(float) << " bytes of ratings instead of "
+        << (size_t)2 * nPairs * net.getGenomSize() * sizeof(float) << " bytes of genoms" << std::endl;
+
+    int nMaxThreads = SimpleNeuralThreadPool::getDefaultNumberOfThreads();
+    for (int nThreads = 1; nThreads <= nMaxThreads; nThreads *= 2) {
+        SimpleNeuralEvolutionStrategies es(&net, nPairs);
+        es.setNumberOfThreads(nThreads);
+        es.setRandomSeed(1);
+        auto startTime = std::chrono::steady_clock::now();
+        for (int n = 0; n < 5; ++n) {
+            es.step(&trainingData);
+        }
+        double nSeconds = elapsedSeconds(startTime);
+        std::cout << "threads " << nThreads << ": " << 5 * 2 * nPairs / nSeconds << " samples/s" << std::endl;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    int nGenerations = 0;
+    SimpleNeuralGenomList genoms(30, 40, 40);
+    genoms.setNumberOfThreads(0);
+    genoms.setRandomSeed(1);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &trainingData);
+    while (elapsedSeconds(startTime) < nLimitSeconds) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+        ++nGenerations;
+    }
+    std::cout << "genetic: " << elapsedSeconds(startTime) << "s, " << nGenerations << " generations, better rating "
+        << genoms.getBetterRating() << std::endl;
+
+    SimpleNeuralEvolutionStrategies es(&net, nPairs);
+    es.setNumberOfThreads(0);
+    es.setRandomSeed(1);
+    es.setSigma(0.05f);
+    es.setLearningRate(0.01f);
+    startTime = std::chrono::steady_clock::now();
+    while (elapsedSeconds(startTime) < nLimitSeconds) {
+        es.step(&trainingData);
+    }
+    std::vector<float> vParameters = es.getParameters();
+    SimpleNeuralGenom result(vParameters.data(), vParameters.size(), 0.0f);
+    result.calculateRating(&net, &trainingData);
+    std::cout << "evolution strategies: " << elapsedSeconds(startTime) << "s, " << es.getGeneration()
+        << " generations of " << 2 * nPairs << ", rating " << result.getRating() << std::endl;
+}
+
+// generations of the genetic algorithm to the target rating (or the rating at the limit of generations)
+void runGenerationsToTarget(
+    SimpleNeuralNetwork &net,
+    SimpleNeuralTrainingItemList &trainingData,
+    bool bSelfAdaptive,
+    uint64_t nSeed,
+    float nTarget,
+    int nMaxGenerations
+) {
+    SimpleNeuralGenomList genoms(30, 40, 40);
+    genoms.setNumberOfThreads(0);
+    genoms.setRandomSeed(nSeed);
+    genoms.setRacing(true);
+    genoms.setSelfAdaptiveMutation(bSelfAdaptive);
+    genoms.fillRandom(&net);
+    auto start = std::chrono::steady_clock::now();
+    genoms.calculateRatingForAll(&net, &trainingData);
+    int nGenerations = 0;
+    while (genoms.getBetterRating() > nTarget && nGenerations < nMaxGenerations) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+        ++nGenerations;
+    }
+    std::cout << (bSelfAdaptive ? "self-adaptive" : "fixed 1%") << " (seed " << nSeed << "): "
+        << (genoms.getBetterRating() <= nTarget ? "" : "not reached, ") << nGenerations << " generations, "
+        << elapsedSeconds(start) << "s, better rating " << genoms.getBetterRating()
+        << ", step of better " << genoms.getBetterGenom().getSigma() << std::endl;
+}
+
+void benchmarkSelfAdaptiveMutation(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- self-adaptive mutation ------- " << std::endl;
+    // the data and networks of sum_numbers, car_learning and mesh_calc_tangents examples
+    SimpleNeuralTrainingItemList sumData(2, 1);
+    for (int i = 0; i < 1000; ++i) {
+        float in0 = static_cast<float>(std::rand() % 100);
+        float in1 = static_cast<float>(std::rand() % 100);
+        sumData.addItem({in0, in1}, {in0 + in1});
+    }
+    SimpleNeuralNetwork sumNet({2, 64, 64, 1});
+    std::cout << "sum_numbers, target 0.1:" << std::endl;
+    for (uint64_t nSeed = 1; nSeed <= 3; ++nSeed) {
+        runGenerationsToTarget(sumNet, sumData, false, nSeed, 0.1f, 1000);
+        runGenerationsToTarget(sumNet, sumData, true, nSeed, 0.1f, 1000);
+    }
+
+    SimpleNeuralNetwork carNet({trainingData.getNumberOfIn(), 64, 128, 64, trainingData.getNumberOfOut()});
+    std::cout << "car_learning, target 20000:" << std::endl;
+    runGenerationsToTarget(carNet, trainingData, false, 1, 20000.0f, 40);
+    runGenerationsToTarget(carNet, trainingData, true, 1, 20000.0f, 40);
+
+    SimpleNeuralTrainingItemList meshData(57, 4);
+    initMeshTrainingData(meshData);
+    SimpleNeuralNetwork meshNet({meshData.getNumberOfIn(), 30, 71, 8, meshData.getNumberOfOut()});
+    std::cout << "mesh_calc_tangents, target 3:" << std::endl;
+    runGenerationsToTarget(meshNet, meshData, false, 1, 3.0f, 40);
+    runGenerationsToTarget(meshNet, meshData, true, 1, 3.0f, 40);
+}
+
+// the rating as it was before the fused kernel: calc() of every item and the loss by its outputs
+float ratingByCalc(SimpleNeuralNetwork &net, SimpleNeuralTrainingItemList &trainingData, const float *pWeights) {
+    float nSumDiffs = 0.0f;
+    for (auto it = trainingData.begin(); it != trainingData.end(); ++it) {
+        const std::vector<float> &vOutNet = net.calc(pWeights, it->getIn());
+        const std::vector<float> &vOutExpected = it->getOut();
+        float ret = 0.0f;
+        for (int i = 0; i < vOutNet.size(); i++) {
+            ret += (vOutExpected[i] - vOutNet[i]) * (vOutExpected[i] - vOutNet[i]);
+        }
+        nSumDiffs += std::sqrt(ret);
+    }
+    return nSumDiffs / trainingData.size();
+}
+
+void benchmarkLossKernel(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- loss kernel ------- " << std::endl;
+    constexpr int nGenoms = 40;
+    SimpleNeuralNetwork net({trainingData.getNumberOfIn(), 64, 128, 64, trainingData.getNumberOfOut()});
+    SimpleNeuralGenomList genoms(10, 15, 15);
+    genoms.setRandomSeed(1);
+    genoms.fillRandom(&net);
+
+    auto start = std::chrono::steady_clock::now();
+    float nCheck = 0.0f;
+    for (int i = 0; i < nGenoms; ++i) {
+        nCheck += ratingByCalc(net, trainingData, genoms.list()[i].getWeights());
+    }
+    double nCalcSeconds = elapsedSeconds(start);
+    std::cout << "calc() per item: " << nCalcSeconds << "s for " << nGenoms << " genoms" << std::endl;
+
+    const SimpleNeuralLoss vLosses[] = {
+        SimpleNeuralLoss::Euclidean,
+        SimpleNeuralLoss::MeanSquared,
+        SimpleNeuralLoss::MeanAbsolute,
+        SimpleNeuralLoss::MaxError
+    };
+    const char *vNames[] = {"euclidean", "mean squared", "mean absolute", "max error"};
+    for (int nLoss = 0; nLoss < 4; ++nLoss) {
+        net.setLoss(vLosses[nLoss]);
+        std::vector<float> vWeights(net.getGenomSize());
+        float nSum = 0.0f;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nGenoms; ++i) {
+            SimpleNeuralGenom genom(const_cast<float *>(genoms.list()[i].getWeights()), net.getGenomSize(), 0.0f);
+            genom.calculateRating(&net, &trainingData);
+            nSum += genom.getRating();
+        }
+        double nSeconds = elapsedSeconds(start);
+        std::cout << "fused kernel, " << vNames[nLoss] << ": " << nSeconds << "s, speedup " << nCalcSeconds / nSeconds;
+        if (nLoss == 0) {
+            std::cout << (nSum == nCheck ? ", the same ratings" : ", DIFFERENT ratings");
+        }
+        std::cout << std::endl;
+    }
+}
+
+std::string layersToString(const std::vector<int> &vLayers) {
+    std::string sLayers;
+    for (int i = 0; i < vLayers.size(); ++i) {
+        sLayers += (i == 0 ? "" : ", ") + std::to_string(vLayers[i]);
+    }
+    return sLayers;
+}
+
+void printPruningResult(const SimpleNeuralPruningResult &result, double nSeconds) {
+    std::cout << "layers " << layersToString(result.vLayers) << ": " << result.nRemovedNeurons << " neurons removed ("
+        << result.nFineTunings << " after fine-tuning), " << nSeconds << "s, rating " << result.nOriginalRating
+        << " -> " << result.nRating << ", calc " << result.nOriginalCalcNanoseconds << "ns -> "
+        << result.nCalcNanoseconds << "ns, speedup " << result.nCalcSpeedup << std::endl;
+}
+
+void benchmarkPruning() {
+    std::cout << " ------- pruning ------- " << std::endl;
+    // the over-provisioned network of mesh_calc_tangents example
+    SimpleNeuralTrainingItemList meshData(57, 4);
+    initMeshTrainingData(meshData);
+    SimpleNeuralNetwork net({meshData.getNumberOfIn(), 30, 71, 8, meshData.getNumberOfOut()});
+    SimpleNeuralGenomList genoms(30, 40, 40);
+    genoms.setNumberOfThreads(0);
+    genoms.setRandomSeed(1);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &meshData);
+    for (int n = 0; n < 30; ++n) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &meshData);
+    }
+    net.setGenom(genoms.getBetterGenom().getGenom());
+    std::cout << "trained 30 generations, rating " << genoms.getBetterRating() << std::endl;
+
+    SimpleNeuralPruner pruner(&net);
+    auto start = std::chrono::steady_clock::now();
+    SimpleNeuralPruningResult result = pruner.prune(&meshData);
+    std::cout << "tolerance 5%: ";
+    printPruningResult(result, elapsedSeconds(start));
+
+    SimpleNeuralGenomList fineTuning(10, 20, 20);
+    fineTuning.setNumberOfThreads(0);
+    fineTuning.setRandomSeed(1);
+    pruner.setFineTuning(&fineTuning, 5);
+    start = std::chrono::steady_clock::now();
+    result = pruner.prune(&meshData);
+    std::cout << "tolerance 5%, fine-tuning 5 generations: ";
+    printPruningResult(result, elapsedSeconds(start));
+}
+
+void benchmarkGramEvaluator(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- gram statistics ------- " << std::endl;
+    constexpr int nGenoms = 40;
+    SimpleNeuralNetwork net({trainingData.getNumberOfIn(), 64, 128, 64, trainingData.getNumberOfOut()});
+    net.setLoss(SimpleNeuralLoss::MeanSquared);
+    SimpleNeuralGenomList genoms(10, 15, 15);
+    genoms.setRandomSeed(1);
+    genoms.fillRandom(&net);
+
+    // the cost of the rating by the pass over the data grows with it, by the statistics - not
+    SimpleNeuralTrainingItemList data(trainingData.getNumberOfIn(), trainingData.getNumberOfOut());
+    for (int nCopies = 1; nCopies <= 4; nCopies *= 2) {
+        while (data.size() < trainingData.size() * nCopies) {
+            for (auto it = trainingData.begin(); it != trainingData.end(); ++it) {
+                data.addItem(it->getIn(), it->getOut());
+            }
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::vector<float> vExpected;
+        for (int i = 0; i < nGenoms; ++i) {
+            SimpleNeuralGenom genom(const_cast<float *>(genoms.list()[i].getWeights()), net.getGenomSize(), 0.0f);
+            genom.calculateRating(&net, &data);
+            vExpected.push_back(genom.getRating());
+        }
+        double nPassSeconds = elapsedSeconds(start);
+
+        start = std::chrono::steady_clock::now();
+        SimpleNeuralGramEvaluator evaluator(&net, &data);
+        double nStatisticsSeconds = elapsedSeconds(start);
+        start = std::chrono::steady_clock::now();
+        float nMaxDifference = 0.0f;
+        for (int i = 0; i < nGenoms; ++i) {
+            SimpleNeuralGenom genom(const_cast<float *>(genoms.list()[i].getWeights()), net.getGenomSize(), 0.0f);
+            evaluator.calculateRating(genom);
+            nMaxDifference = std::max(nMaxDifference, std::fabs(genom.getRating() - vExpected[i]) / vExpected[i]);
+        }
+        double nGramSeconds = elapsedSeconds(start);
+        std::cout << data.size() << " samples, " << nGenoms << " genoms: pass over data " << nPassSeconds
+            << "s, statistics once " << nStatisticsSeconds << "s + ratings " << nGramSeconds << "s, speedup "
+            << nPassSeconds / nGramSeconds << ", max relative difference " << nMaxDifference << std::endl;
+    }
+}
+
+void runScreened(SimpleNeuralNetwork &net, SimpleNeuralTrainingItemList &trainingData, int nProbeSize, float nShare, double nSeconds) {
+    SimpleNeuralGenomList genoms(30, 40, 40);
+    genoms.setRandomSeed(1);
+    genoms.setPreScreening(nProbeSize, nShare, 5);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &trainingData);
+    auto start = std::chrono::steady_clock::now();
+    int nGenerations = 0;
+    while (elapsedSeconds(start) < nSeconds) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+        ++nGenerations;
+    }
+    std::cout << "probe " << nProbeSize << ", share " << nShare << ": " << nGenerations << " generations in "
+        << nSeconds << "s, better rating " << genoms.getBetterRating()
+        << ", false reject rate " << genoms.getScreeningFalseRejectRate() << std::endl;
+}
+
+void benchmarkPreScreening(SimpleNeuralTrainingItemList &trainingData) {
+    std::cout << " ------- pre-screening of children ------- " << std::endl;
+    SimpleNeuralNetwork net({trainingData.getNumberOfIn(), 64, 128, 64, trainingData.getNumberOfOut()});
+    runScreened(net, trainingData, 0, 1.0f, 10.0);
+    runScreened(net, trainingData, 100, 0.5f, 10.0);
+    runScreened(net, trainingData, 100, 0.25f, 10.0);
+    runScreened(net, trainingData, 400, 0.25f, 10.0);
+}
+
+int main(int argc, char *argv[]) {
+    std::srand(std::time(nullptr));
+    std::string sName = argc > 1 ? argv[1] : "all";
+
+    SimpleNeuralTrainingItemList trainingData(25, 2);
+    initCarLearningTrainingData(trainingData);
+
+    if (sName == "all" || sName == "batch") {
+        benchmarkBatchEvaluator(trainingData);
+    }
+    if (sName == "all" || sName == "offspring") {
+        benchmarkOffspring(trainingData);
+    }
+    if (sName == "all" || sName == "delta") {
+        benchmarkDeltaEvaluator(trainingData);
+    }
+    if (sName == "all" || sName == "islands") {
+        benchmarkIslands(trainingData);
+    }
+    if (sName == "all" || sName == "steady") {
+        benchmarkSteadyState(trainingData);
+    }
+    if (sName == "all" || sName == "gradient") {
+        benchmarkGradientTrainer(trainingData);
+    }
+    if (sName == "all" || sName == "lsq") {
+        benchmarkLeastSquares(trainingData);
+    }
+    if (sName == "all" || sName == "cmaes") {
+        benchmarkCmaEs(trainingData);
+    }
+    if (sName == "all" || sName == "es") {
+        benchmarkEvolutionStrategies(trainingData);
+    }
+    if (sName == "all" || sName == "sigma") {
+        benchmarkSelfAdaptiveMutation(trainingData);
+    }
+    if (sName == "all" || sName == "loss") {
+        benchmarkLossKernel(trainingData);
+    }
+    if (sName == "all" || sName == "prune") {
+        benchmarkPruning();
+    }
+    if (sName == "all" || sName == "gram") {
+        benchmarkGramEvaluator(trainingData);
+    }
+    if (sName == "all" || sName == "screen") {
+        benchmarkPreScreening(trainingData);
+    }
+    return 0;
+}
@@ -30,8 +30,11 @@ SOFTWARE.
 #include <sstream>
 #include <fstream>
 #include <string>
+#include <cstdio>
 
 #include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralRatingCache.h"
+#include "SimpleNeuralCheckpoint.h"
 
 void initTrainingData(SimpleNeuralTrainingItemList &trainingData) {
     std::string sFilename = "examples/car_learning/data.txt";
@@ -75,16 +78,43 @@ int main(int argc, char *argv[]) {
     constexpr int nMutateSpecimens = 40;
     constexpr int nMixSpecimens = 40;
     SimpleNeuralGenomList genoms(nBetterSpecimens, nMutateSpecimens, nMixSpecimens);
-    genoms.fillRandom(pNet); // TODO fill can be randomly, no need net
-    genoms.calculateRatingForAll(pNet, &trainingData);
+    genoms.setNumberOfThreads(0); // all cores
+    genoms.setRacing(true); // stop rating of a child which can not get into better
+    genoms.setRatingCache(100); // do not rate the same genom twice (about 7 MB, 72 KB per genom)
+
+    // the interrupted run is continued from the last checkpoint
+    const std::string sCheckpointFilename = "car_learning.checkpoint";
+    constexpr int nCheckpointInterval = 100;
+    SimpleNeuralCheckpoint checkpoint;
+    SimpleNeuralCheckpointWriter checkpointWriter;
+
+    // time of phases and ratings of every generation, one JSON object per line
+    std::ofstream telemetryFile("car_learning.telemetry.jsonl", std::ofstream::out | std::ofstream::app);
+    SimpleNeuralTelemetryWriter telemetry(telemetryFile, SimpleNeuralTelemetryFormat::JsonLines);
+    genoms.setTelemetry(&telemetry);
+    if (std::ifstream(sCheckpointFilename.c_str()).good()) {
+        checkpoint.load(sCheckpointFilename);
+        genoms.setCheckpoint(checkpoint, pNet); // throws on checkpoint of other network
+        std::cout << "Continue from generation " << genoms.getGeneration() << std::endl;
+    } else {
+        genoms.fillRandom(pNet); // TODO fill can be randomly, no need net
+        genoms.calculateRatingForAll(pNet, &trainingData);
+    }
 
     constexpr int nMaxGenerations = 5000;
     constexpr float nConditionRatingStop = 2.0f;
-    int n = 0;
+    int n = genoms.getGeneration();
     while (genoms.getBetterRating() > nConditionRatingStop && n < nMaxGenerations) {
         ++n;
-
         auto start = std::chrono::steady_clock::now();
+        if (n % nCheckpointInterval == 0) {
+            // the snapshot is written on the background thread
+            genoms.getCheckpoint(checkpoint);
+            checkpointWriter.write(checkpoint, sCheckpointFilename);
+            genoms.addPhaseSeconds(SimpleNeuralPhase::IO, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        start = std::chrono::steady_clock::now();
         genoms.sort(); // better generations will be on the top
 
         std::cout << " ------- Generation " << n << " ------- " << std::endl;
@@ -101,9 +131,17 @@ int main(int argc, char *argv[]) {
             << "ms" << std::endl
         ;
         std::cout << "calc avarage time: " << pNet->getCalcAvarageTimeInNanoseconds() << "ns" << std::endl;
+        std::cout << "racing: rejected " << genoms.getNumberOfRejected() << " genoms, skipped "
+            << int(genoms.getRacingSavedShare() * 100.0f) << "% of training items" << std::endl;
+        std::cout << "rating cache: " << int(genoms.getRatingCache()->getHitRate() * 100.0f) << "% hits" << std::endl;
+        std::cout << "evaluations: " << int(genoms.getGenerationStats().getEvaluationsPerSecond()) << " genoms/s" << std::endl;
     }
 
-    const std::vector<float> &vBetterGenom = genoms.list()[0].getGenom();
+    // the run is finished, the next one starts from the beginning and not from this end
+    checkpointWriter.wait();
+    std::remove(sCheckpointFilename.c_str());
+
+    const std::vector<float> &vBetterGenom = genoms.getBetterGenom().getGenom();
 
     std::ofstream file;
     file.open("best_genom.txt", std::ofstream::out);
@@ -126,6 +126,7 @@ int main(int argc, char *argv[]) {
     constexpr int nMutateSpecimens = 40;
     constexpr int nMixSpecimens = 40;
     SimpleNeuralGenomList genoms(nBetterSpecimens, nMutateSpecimens, nMixSpecimens);
+    genoms.setNumberOfThreads(0); // all cores
     genoms.fillRandom(pNet); // TODO fill can be randomly, no need net
     std::cout << "First calc... " << std::endl;
     genoms.calculateRatingForAll(pNet, &trainingData);
@@ -163,7 +164,7 @@ int main(int argc, char *argv[]) {
         );
     }
 
-    const std::vector<float> &vBetterGenom = genoms.list()[0].getGenom();
+    const std::vector<float> &vBetterGenom = genoms.getBetterGenom().getGenom();
 
     std::cout << "calc avarage time: " << pNet->getCalcAvarageTimeInNanoseconds() << "ns" << std::endl;
 	return 0;
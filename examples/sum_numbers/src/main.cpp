@@ -74,6 +74,7 @@ int main(int argc, char *argv[]) {
     constexpr int nMutateSpecimens = 40;
     constexpr int nMixSpecimens = 40;
     SimpleNeuralGenomList genoms(nBetterSpecimens, nMutateSpecimens, nMixSpecimens);
+    genoms.setNumberOfThreads(0); // all cores
     genoms.fillRandom(pNet); // TODO fill can be randomly, no need net
     genoms.calculateRatingForAll(pNet, &trainingData);
 
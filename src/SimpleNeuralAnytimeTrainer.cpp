@@ -0,0 +1,138 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralAnytimeTrainer.h"
+#include "SimpleNeuralNetwork.h"
+
+#include <limits>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralCancellationToken
+
+SimpleNeuralCancellationToken::SimpleNeuralCancellationToken() {
+    m_bCancelled = false;
+}
+
+void SimpleNeuralCancellationToken::cancel() {
+    m_bCancelled.store(true, std::memory_order_relaxed);
+}
+
+void SimpleNeuralCancellationToken::reset() {
+    m_bCancelled.store(false, std::memory_order_relaxed);
+}
+
+bool SimpleNeuralCancellationToken::isCancelled() const {
+    return m_bCancelled.load(std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------------------
+// SimpleNeuralBudget
+
+SimpleNeuralBudget::SimpleNeuralBudget() {
+    m_bDeadline = false;
+    m_pToken = nullptr;
+}
+
+SimpleNeuralBudget::SimpleNeuralBudget(double nSeconds, const SimpleNeuralCancellationToken *pToken) {
+    m_deadline = std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(nSeconds));
+    m_bDeadline = true;
+    m_pToken = pToken;
+}
+
+void SimpleNeuralBudget::setDeadline(std::chrono::steady_clock::time_point deadline) {
+    m_deadline = deadline;
+    m_bDeadline = true;
+}
+
+void SimpleNeuralBudget::setCancellationToken(const SimpleNeuralCancellationToken *pToken) {
+    m_pToken = pToken;
+}
+
+bool SimpleNeuralBudget::isCancelled() const {
+    return m_pToken != nullptr && m_pToken->isCancelled();
+}
+
+bool SimpleNeuralBudget::isExpired() const {
+    return m_bDeadline && std::chrono::steady_clock::now() >= m_deadline;
+}
+
+bool SimpleNeuralBudget::isExhausted() const {
+    return this->isCancelled() || this->isExpired();
+}
+
+double SimpleNeuralBudget::getRemainingSeconds() const {
+    if (!m_bDeadline) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double nSeconds = std::chrono::duration<double>(m_deadline - std::chrono::steady_clock::now()).count();
+    return nSeconds > 0.0 ? nSeconds : 0.0;
+}
+
+// ---------------------------------------------------------------------
+// SimpleNeuralAnytimeTrainer
+
+SimpleNeuralAnytimeTrainer::SimpleNeuralAnytimeTrainer(SimpleNeuralGenomList *pGenoms) {
+    m_pGenoms = pGenoms;
+    m_nTargetRating = 0.0f;
+}
+
+void SimpleNeuralAnytimeTrainer::setTargetRating(float nTargetRating) {
+    m_nTargetRating = nTargetRating;
+}
+
+SimpleNeuralTrainingResult SimpleNeuralAnytimeTrainer::train(
+    SimpleNeuralNetwork *pNet,
+    SimpleNeuralTrainingItemList *pTrainingData,
+    const SimpleNeuralBudget &budget
+) {
+    auto start = std::chrono::steady_clock::now();
+    long long nFirstGeneration = m_pGenoms->getGeneration();
+    m_pGenoms->setBudget(&budget);
+    if (m_pGenoms->list().empty()) {
+        m_pGenoms->fillRandom(pNet);
+        m_pGenoms->calculateRatingForAll(pNet, pTrainingData);
+    }
+    while (m_pGenoms->getBetterRating() > m_nTargetRating && !budget.isExhausted()) {
+        m_pGenoms->sort();
+        m_pGenoms->mutateAndMix(pNet);
+        m_pGenoms->calculateRatingForMutatedAndMixed(pNet, pTrainingData);
+    }
+    m_pGenoms->setBudget(nullptr);
+
+    SimpleNeuralTrainingResult result;
+    const SimpleNeuralGenom &better = m_pGenoms->getBetterGenom();
+    result.vGenom = better.getGenom();
+    result.nRating = better.getRating();
+    result.nGenerations = m_pGenoms->getGeneration() - nFirstGeneration;
+    result.nSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (result.nRating <= m_nTargetRating && !better.isRejected()) {
+        result.nReason = SimpleNeuralStopReason::TargetRating;
+    } else if (budget.isCancelled()) {
+        result.nReason = SimpleNeuralStopReason::Cancelled;
+    } else {
+        result.nReason = SimpleNeuralStopReason::Deadline;
+    }
+    return result;
+}
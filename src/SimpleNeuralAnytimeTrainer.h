@@ -0,0 +1,101 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_ANYTIME_TRAINER_H__
+#define __SIMPLE_NEURAL_ANYTIME_TRAINER_H__
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+
+class SimpleNeuralNetwork;
+class SimpleNeuralTrainingItemList;
+class SimpleNeuralGenomList;
+
+// Stops the training from other thread (for example from the signal handler of the job)
+class SimpleNeuralCancellationToken {
+    public:
+        SimpleNeuralCancellationToken();
+        void cancel();
+        void reset();
+        bool isCancelled() const;
+
+    private:
+        std::atomic<bool> m_bCancelled;
+};
+
+// Deadline and optional cancellation token, checked before rating of every genom
+class SimpleNeuralBudget {
+    public:
+        SimpleNeuralBudget(); // no limit
+        explicit SimpleNeuralBudget(double nSeconds, const SimpleNeuralCancellationToken *pToken = nullptr);
+        void setDeadline(std::chrono::steady_clock::time_point deadline);
+        void setCancellationToken(const SimpleNeuralCancellationToken *pToken);
+
+        bool isCancelled() const;
+        bool isExpired() const; // the deadline is passed
+        bool isExhausted() const; // expired or cancelled
+        double getRemainingSeconds() const;
+
+    private:
+        std::chrono::steady_clock::time_point m_deadline;
+        bool m_bDeadline;
+        const SimpleNeuralCancellationToken *m_pToken;
+};
+
+enum class SimpleNeuralStopReason {
+    TargetRating,
+    Deadline,
+    Cancelled
+};
+
+struct SimpleNeuralTrainingResult {
+    std::vector<float> vGenom; // the better genom so far
+    float nRating = 0.0f;
+    long long nGenerations = 0;
+    double nSeconds = 0.0;
+    SimpleNeuralStopReason nReason = SimpleNeuralStopReason::TargetRating;
+};
+
+// Runs the genetic algorithm of the list until the target rating or the end of budget.
+// The budget is checked between ratings of genoms, so the last generation can be stopped
+// in the middle: not rated children are rejected and do not get into better genoms.
+class SimpleNeuralAnytimeTrainer {
+    public:
+        explicit SimpleNeuralAnytimeTrainer(SimpleNeuralGenomList *pGenoms);
+        void setTargetRating(float nTargetRating); // 0 by default
+
+        // fills the list by random genoms, if it's empty
+        SimpleNeuralTrainingResult train(
+            SimpleNeuralNetwork *pNet,
+            SimpleNeuralTrainingItemList *pTrainingData,
+            const SimpleNeuralBudget &budget
+        );
+
+    private:
+        SimpleNeuralGenomList *m_pGenoms;
+        float m_nTargetRating;
+};
+
+#endif // __SIMPLE_NEURAL_ANYTIME_TRAINER_H__
@@ -0,0 +1,158 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralBatchEvaluator.h"
+#include "SimpleNeuralNetwork.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <math.h>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralBatchEvaluator
+
+SimpleNeuralBatchEvaluator::SimpleNeuralBatchEvaluator(
+    SimpleNeuralNetwork *pNet,
+    SimpleNeuralTrainingItemList *pTrainingData,
+    int nGenomsBlock
+)
+    : m_vLayers(pNet->getLayers())
+    , m_nGenomsBlock(std::max(1, nGenomsBlock))
+    , m_nGenomSamplesCounter(0)
+{
+    if (pTrainingData->getNumberOfIn() != m_vLayers[0] || pTrainingData->getNumberOfOut() != m_vLayers.back()) {
+        throw std::runtime_error("Training data does not fit to the network!");
+    }
+    if (pNet->getLoss() != SimpleNeuralLoss::Euclidean) {
+        throw std::runtime_error("SimpleNeuralBatchEvaluator: only Euclidean loss is supported");
+    }
+    m_nInputSize = m_vLayers[0];
+    m_nOutputSize = m_vLayers.back();
+    m_nMaxLayerSize = *std::max_element(m_vLayers.begin(), m_vLayers.end());
+    m_nSamples = pTrainingData->size();
+    m_nTiles = (m_nSamples + TILE_SAMPLES - 1) / TILE_SAMPLES;
+
+    // pack training data, the tail of the last tile is zeros
+    m_vPackedIn.assign(m_nTiles * m_nInputSize * TILE_SAMPLES, 0.0f);
+    m_vPackedOut.assign(m_nTiles * m_nOutputSize * TILE_SAMPLES, 0.0f);
+    int nSample = 0;
+    for (auto it = pTrainingData->begin(); it != pTrainingData->end(); ++it) {
+        int nTile = nSample / TILE_SAMPLES;
+        int nS = nSample % TILE_SAMPLES;
+        const std::vector<float> &vIn = it->getIn();
+        const std::vector<float> &vOut = it->getOut();
+        for (int i = 0; i < m_nInputSize; ++i) {
+            m_vPackedIn[(nTile * m_nInputSize + i) * TILE_SAMPLES + nS] = vIn[i];
+        }
+        for (int i = 0; i < m_nOutputSize; ++i) {
+            m_vPackedOut[(nTile * m_nOutputSize + i) * TILE_SAMPLES + nS] = vOut[i];
+        }
+        ++nSample;
+    }
+    this->setNumberOfWorkers(1);
+}
+
+int SimpleNeuralBatchEvaluator::getGenomsBlock() const {
+    return m_nGenomsBlock;
+}
+
+void SimpleNeuralBatchEvaluator::setNumberOfWorkers(int nWorkers) {
+    m_vScratch.resize(std::max(1, nWorkers));
+    for (int i = 0; i < m_vScratch.size(); ++i) {
+        m_vScratch[i].vSignals0.resize(m_nMaxLayerSize * TILE_SAMPLES);
+        m_vScratch[i].vSignals1.resize(m_nMaxLayerSize * TILE_SAMPLES);
+        m_vScratch[i].vSumDiffs.resize(m_nGenomsBlock);
+    }
+}
+
+long long SimpleNeuralBatchEvaluator::getGenomSamplesCounter() const {
+    return m_nGenomSamplesCounter;
+}
+
+void SimpleNeuralBatchEvaluator::calculateRating(SimpleNeuralGenom *pGenoms, int nCount, int nWorker) {
+    Scratch &scratch = m_vScratch[nWorker];
+    for (int nFirst = 0; nFirst < nCount; nFirst += m_nGenomsBlock) {
+        int nBlock = std::min(m_nGenomsBlock, nCount - nFirst);
+        std::fill(scratch.vSumDiffs.begin(), scratch.vSumDiffs.end(), 0.0f);
+        // tile is the outer loop: the same inputs for every genom of the block
+        for (int nTile = 0; nTile < m_nTiles; ++nTile) {
+            for (int g = 0; g < nBlock; ++g) {
+                this->calcTile(pGenoms[nFirst + g].getWeights(), nTile, scratch, scratch.vSumDiffs[g]);
+            }
+        }
+        for (int g = 0; g < nBlock; ++g) {
+            pGenoms[nFirst + g].setRating(scratch.vSumDiffs[g] / float(m_nSamples));
+        }
+    }
+    m_nGenomSamplesCounter += (long long)nCount * m_nSamples;
+}
+
+void SimpleNeuralBatchEvaluator::calcTile(const float *pWeights, int nTile, Scratch &scratch, float &nSumDiffs) {
+    constexpr int T = TILE_SAMPLES;
+    float *pPrev = scratch.vSignals0.data();
+    float *pNext = scratch.vSignals1.data();
+
+    const float *pIn = m_vPackedIn.data() + nTile * m_nInputSize * T;
+    for (int i = 0; i < m_nInputSize; ++i) {
+        const float nWeight = pWeights[i];
+        for (int s = 0; s < T; ++s) {
+            pPrev[i * T + s] = pIn[i * T + s] * nWeight;
+        }
+    }
+
+    int nWeightOffset = m_nInputSize;
+    for (int nL = 1; nL < m_vLayers.size(); ++nL) {
+        int nPrevLayerSize = m_vLayers[nL - 1];
+        int nLayerSize = m_vLayers[nL];
+        for (int nN = 0; nN < nLayerSize; ++nN) {
+            // row of samples for neuron nN, inner loop over samples is vectorized
+            float *pSum = pNext + nN * T;
+            for (int s = 0; s < T; ++s) {
+                pSum[s] = 0.0f;
+            }
+            for (int nP = 0; nP < nPrevLayerSize; ++nP) {
+                const float nWeight = pWeights[nWeightOffset];
+                const float *pSignal = pPrev + nP * T;
+                for (int s = 0; s < T; ++s) {
+                    pSum[s] += pSignal[s] * nWeight;
+                }
+                ++nWeightOffset;
+            }
+        }
+        std::swap(pPrev, pNext);
+    }
+
+    const float *pExpected = m_vPackedOut.data() + nTile * m_nOutputSize * T;
+    int nValid = std::min(T, m_nSamples - nTile * T);
+    for (int s = 0; s < nValid; ++s) {
+        float ret = 0;
+        for (int i = 0; i < m_nOutputSize; ++i) {
+            float x1 = pPrev[i * T + s];
+            float x2 = pExpected[i * T + s];
+            ret += (x2 - x1)*(x2 - x1);
+        }
+        ret = std::sqrt(ret);
+        nSumDiffs += ret;
+    }
+}
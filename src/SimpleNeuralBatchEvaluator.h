@@ -0,0 +1,75 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_BATCH_EVALUATOR_H__
+#define __SIMPLE_NEURAL_BATCH_EVALUATOR_H__
+
+#include <vector>
+#include <atomic>
+
+class SimpleNeuralNetwork;
+class SimpleNeuralTrainingItemList;
+class SimpleNeuralGenom;
+
+// Rates a block of genoms on tiles of training samples.
+// Training data is packed once (tile by tile, transposed: value-major),
+// so one tile of inputs stays in cache while all genoms of the block are applied.
+// Every layer is calculated as a small matrix multiplication (neurons x samples),
+// sums are accumulated in the same order as in SimpleNeuralNetwork::calc,
+// so the ratings are exactly the same as SimpleNeuralGenom::calculateRating gives.
+// Only the Euclidean loss is supported.
+class SimpleNeuralBatchEvaluator {
+    public:
+        SimpleNeuralBatchEvaluator(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, int nGenomsBlock = 8);
+
+        int getGenomsBlock() const;
+        void setNumberOfWorkers(int nWorkers);
+        long long getGenomSamplesCounter() const;
+        // rate genoms pGenoms[0..nCount), nWorker selects the scratch buffers (0 <= nWorker < number of workers)
+        void calculateRating(SimpleNeuralGenom *pGenoms, int nCount, int nWorker = 0);
+
+        static constexpr int TILE_SAMPLES = 32;
+
+    private:
+        struct Scratch {
+            std::vector<float> vSignals0;
+            std::vector<float> vSignals1;
+            std::vector<float> vSumDiffs;
+        };
+        void calcTile(const float *pWeights, int nTile, Scratch &scratch, float &nSumDiffs);
+
+        std::vector<int> m_vLayers;
+        int m_nGenomsBlock;
+        int m_nInputSize;
+        int m_nOutputSize;
+        int m_nMaxLayerSize;
+        int m_nSamples;
+        int m_nTiles;
+        std::vector<float> m_vPackedIn;  // [tile][in][TILE_SAMPLES]
+        std::vector<float> m_vPackedOut; // [tile][out][TILE_SAMPLES]
+        std::vector<Scratch> m_vScratch; // one per worker
+        std::atomic<long long> m_nGenomSamplesCounter;
+};
+
+#endif // __SIMPLE_NEURAL_BATCH_EVALUATOR_H__
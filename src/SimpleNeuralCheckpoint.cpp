@@ -0,0 +1,286 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralCheckpoint.h"
+
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <io.h>
+#endif
+
+namespace {
+
+const uint32_t CHECKPOINT_MAGIC = 0x434e4e53; // "SNNC"
+const uint32_t CHECKPOINT_VERSION = 2; // 1 - without steps of mutation
+
+struct CheckpointHeader {
+    uint32_t nMagic;
+    uint32_t nVersion;
+    uint32_t nGenoms;
+    uint32_t nGenomSize;
+    uint64_t nRandomSeed;
+    int64_t nGeneration;
+    int64_t nMiniBatchEpoch;
+    int32_t nMiniBatchPosition;
+    uint32_t nMiniBatchOrderSize;
+};
+
+// ratings, rejected flags, steps of mutation (since version 2), order of mini-batch, weights
+size_t checkpointSize(const CheckpointHeader &header) {
+    return sizeof(CheckpointHeader)
+        + header.nGenoms * sizeof(float)
+        + header.nGenoms * sizeof(uint8_t)
+        + (header.nVersion >= 2 ? header.nGenoms * sizeof(float) : 0)
+        + header.nMiniBatchOrderSize * sizeof(int32_t)
+        + (size_t)header.nGenoms * header.nGenomSize * sizeof(float);
+}
+
+// the data is on the disk, not only in the cache of the system
+bool syncFile(FILE *pFile) {
+    if (std::fflush(pFile) != 0) {
+        return false;
+    }
+#ifndef _WIN32
+    return ::fsync(::fileno(pFile)) == 0;
+#else
+    return ::_commit(::_fileno(pFile)) == 0;
+#endif
+}
+
+// the renamed entry is on the disk (no directory sync on Windows)
+void syncDirectoryOf(const std::string &sFilename) {
+#ifndef _WIN32
+    size_t nSlash = sFilename.rfind('/');
+    std::string sDirectory = nSlash == std::string::npos ? "." : (nSlash == 0 ? "/" : sFilename.substr(0, nSlash));
+    int nDirectory = ::open(sDirectory.c_str(), O_RDONLY);
+    if (nDirectory >= 0) {
+        ::fsync(nDirectory);
+        ::close(nDirectory);
+    }
+#endif
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------
+// SimpleNeuralCheckpoint
+
+void SimpleNeuralCheckpoint::save(const std::string &sFilename) const {
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.nMagic = CHECKPOINT_MAGIC;
+    header.nVersion = CHECKPOINT_VERSION;
+    header.nGenoms = vRatings.size();
+    header.nGenomSize = nGenomSize;
+    header.nRandomSeed = nRandomSeed;
+    header.nGeneration = nGeneration;
+    header.nMiniBatchEpoch = nMiniBatchEpoch;
+    header.nMiniBatchPosition = nMiniBatchPosition;
+    header.nMiniBatchOrderSize = vMiniBatchOrder.size();
+    if (vWeights.size() != (size_t)header.nGenoms * nGenomSize || vRejected.size() != header.nGenoms
+        || vSigmas.size() != header.nGenoms) {
+        throw std::runtime_error("SimpleNeuralCheckpoint: wrong size of weights, flags or steps");
+    }
+
+    std::string sTemp = sFilename + ".tmp";
+    FILE *pFile = std::fopen(sTemp.c_str(), "wb");
+    bool bOk = pFile != nullptr
+        && std::fwrite(&header, sizeof(header), 1, pFile) == 1
+        && std::fwrite(vRatings.data(), sizeof(float), vRatings.size(), pFile) == vRatings.size()
+        && std::fwrite(vRejected.data(), sizeof(uint8_t), vRejected.size(), pFile) == vRejected.size()
+        && std::fwrite(vSigmas.data(), sizeof(float), vSigmas.size(), pFile) == vSigmas.size()
+        && std::fwrite(vMiniBatchOrder.data(), sizeof(int32_t), vMiniBatchOrder.size(), pFile) == vMiniBatchOrder.size()
+        && std::fwrite(vWeights.data(), sizeof(float), vWeights.size(), pFile) == vWeights.size()
+        // before the rename, otherwise after the power loss the renamed file can be empty
+        && syncFile(pFile);
+    if (pFile != nullptr) {
+        bOk = std::fclose(pFile) == 0 && bOk;
+    }
+    if (!bOk) {
+        std::remove(sTemp.c_str());
+        throw std::runtime_error("SimpleNeuralCheckpoint: could not write " + sTemp);
+    }
+    // atomic on POSIX: the reader sees the old or the new file, never the half of it
+    if (std::rename(sTemp.c_str(), sFilename.c_str()) != 0) {
+        std::remove(sTemp.c_str());
+        throw std::runtime_error("SimpleNeuralCheckpoint: could not rename " + sTemp + " to " + sFilename);
+    }
+    syncDirectoryOf(sFilename);
+}
+
+void SimpleNeuralCheckpoint::load(const std::string &sFilename) {
+#ifndef _WIN32
+    int nFile = ::open(sFilename.c_str(), O_RDONLY);
+    if (nFile < 0) {
+        throw std::runtime_error("SimpleNeuralCheckpoint: could not open " + sFilename);
+    }
+    struct stat st;
+    if (::fstat(nFile, &st) != 0 || st.st_size < (off_t)sizeof(CheckpointHeader)) {
+        ::close(nFile);
+        throw std::runtime_error("SimpleNeuralCheckpoint: wrong file " + sFilename);
+    }
+    size_t nFileSize = st.st_size;
+    void *pMapped = ::mmap(nullptr, nFileSize, PROT_READ, MAP_PRIVATE, nFile, 0);
+    ::close(nFile);
+    if (pMapped == MAP_FAILED) {
+        throw std::runtime_error("SimpleNeuralCheckpoint: could not map " + sFilename);
+    }
+    const char *pData = static_cast<const char *>(pMapped);
+#else
+    std::ifstream file(sFilename.c_str(), std::ios::binary);
+    std::vector<char> vData((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (vData.size() < sizeof(CheckpointHeader)) {
+        throw std::runtime_error("SimpleNeuralCheckpoint: wrong file " + sFilename);
+    }
+    size_t nFileSize = vData.size();
+    const char *pData = vData.data();
+#endif
+
+    CheckpointHeader header;
+    std::memcpy(&header, pData, sizeof(header));
+    bool bValid = header.nMagic == CHECKPOINT_MAGIC
+        && header.nVersion >= 1 && header.nVersion <= CHECKPOINT_VERSION
+        && checkpointSize(header) == nFileSize;
+    if (bValid) {
+        const char *p = pData + sizeof(header);
+        nRandomSeed = header.nRandomSeed;
+        nGeneration = header.nGeneration;
+        nGenomSize = header.nGenomSize;
+        nMiniBatchEpoch = header.nMiniBatchEpoch;
+        nMiniBatchPosition = header.nMiniBatchPosition;
+        vRatings.resize(header.nGenoms);
+        std::memcpy(vRatings.data(), p, vRatings.size() * sizeof(float));
+        p += vRatings.size() * sizeof(float);
+        vRejected.assign(p, p + header.nGenoms);
+        p += header.nGenoms;
+        vSigmas.clear();
+        if (header.nVersion >= 2) {
+            vSigmas.resize(header.nGenoms);
+            std::memcpy(vSigmas.data(), p, vSigmas.size() * sizeof(float));
+            p += vSigmas.size() * sizeof(float);
+        }
+        vMiniBatchOrder.resize(header.nMiniBatchOrderSize);
+        std::memcpy(vMiniBatchOrder.data(), p, vMiniBatchOrder.size() * sizeof(int32_t));
+        p += vMiniBatchOrder.size() * sizeof(int32_t);
+        vWeights.resize((size_t)header.nGenoms * header.nGenomSize);
+        std::memcpy(vWeights.data(), p, vWeights.size() * sizeof(float));
+    }
+#ifndef _WIN32
+    ::munmap(pMapped, nFileSize);
+#endif
+    if (!bValid) {
+        throw std::runtime_error("SimpleNeuralCheckpoint: wrong format of " + sFilename);
+    }
+}
+
+// ---------------------------------------------------------------------
+// SimpleNeuralCheckpointWriter
+
+SimpleNeuralCheckpointWriter::SimpleNeuralCheckpointWriter() {
+    m_bWriting = false;
+    m_bPending = false;
+    m_nWritten = 0;
+    m_nReplaced = 0;
+}
+
+SimpleNeuralCheckpointWriter::~SimpleNeuralCheckpointWriter() {
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void SimpleNeuralCheckpointWriter::write(SimpleNeuralCheckpoint &checkpoint, const std::string &sFilename) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_bWriting) {
+            // the slow disk does not stop the caller: the snapshot waits for the current write,
+            // the older waiting snapshot is not needed anymore
+            std::swap(m_pending, checkpoint);
+            m_sPendingFilename = sFilename;
+            m_nReplaced += m_bPending ? 1 : 0;
+            m_bPending = true;
+            return;
+        }
+    }
+    this->wait(); // the thread is finished, only the error of it
+    std::swap(m_checkpoint, checkpoint);
+    m_bWriting = true;
+    m_thread = std::thread(&SimpleNeuralCheckpointWriter::run, this, sFilename);
+}
+
+void SimpleNeuralCheckpointWriter::wait() {
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pException) {
+        std::exception_ptr pException = m_pException;
+        m_pException = nullptr;
+        std::rethrow_exception(pException);
+    }
+}
+
+int SimpleNeuralCheckpointWriter::getNumberOfWritten() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nWritten;
+}
+
+int SimpleNeuralCheckpointWriter::getNumberOfReplaced() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nReplaced;
+}
+
+void SimpleNeuralCheckpointWriter::run(std::string sFilename) {
+    while (true) {
+        std::exception_ptr pException;
+        try {
+            m_checkpoint.save(sFilename);
+        } catch (...) {
+            pException = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (pException) {
+            m_pException = pException;
+        } else {
+            ++m_nWritten;
+        }
+        if (!m_bPending) {
+            m_bWriting = false;
+            return;
+        }
+        std::swap(m_checkpoint, m_pending);
+        sFilename = m_sPendingFilename;
+        m_bPending = false;
+    }
+}
@@ -0,0 +1,84 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_CHECKPOINT_H__
+#define __SIMPLE_NEURAL_CHECKPOINT_H__
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <stdint.h>
+
+// State of SimpleNeuralGenomList: genoms, ratings, generation and random state.
+// Random streams of children are taken from (seed, generation, number of genom),
+// so the run continues exactly as without the break.
+struct SimpleNeuralCheckpoint {
+    uint64_t nRandomSeed = 0;
+    long long nGeneration = 0;
+    int nGenomSize = 0;
+    std::vector<float> vWeights; // genoms one by one in the order of the list
+    std::vector<float> vRatings;
+    std::vector<uint8_t> vRejected;
+    std::vector<float> vSigmas; // steps of self-adaptive mutation (empty in files of version 1)
+    long long nMiniBatchEpoch = 0;
+    int nMiniBatchPosition = 0;
+    std::vector<int32_t> vMiniBatchOrder;
+
+    // binary file, written to the temporary file, synced to the disk and renamed,
+    // so the old checkpoint is replaced only by the complete new one (also after the power loss)
+    void save(const std::string &sFilename) const;
+    void load(const std::string &sFilename); // by mmap (not on Windows)
+};
+
+// Writes checkpoints on the background thread, the caller does not wait for the disk:
+// a snapshot given during the write is written after it, a newer one replaces it.
+class SimpleNeuralCheckpointWriter {
+    public:
+        SimpleNeuralCheckpointWriter();
+        ~SimpleNeuralCheckpointWriter(); // waits for the last write
+
+        // the checkpoint is moved to the writer, the caller can fill the next one
+        void write(SimpleNeuralCheckpoint &checkpoint, const std::string &sFilename);
+        void wait(); // waits for all given snapshots, rethrows the error of the last write
+        int getNumberOfWritten() const;
+        int getNumberOfReplaced() const; // not written, a newer snapshot was given during the write
+
+    private:
+        void run(std::string sFilename);
+
+        std::thread m_thread;
+        mutable std::mutex m_mutex;
+        SimpleNeuralCheckpoint m_checkpoint; // in writing
+        SimpleNeuralCheckpoint m_pending;
+        std::string m_sPendingFilename;
+        bool m_bWriting;
+        bool m_bPending;
+        std::exception_ptr m_pException;
+        int m_nWritten;
+        int m_nReplaced;
+};
+
+#endif // __SIMPLE_NEURAL_CHECKPOINT_H__
@@ -0,0 +1,231 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralCmaEs.h"
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralThreadPool.h"
+#include "SimpleNeuralRandom.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralCmaEs
+
+SimpleNeuralCmaEs::SimpleNeuralCmaEs(SimpleNeuralNetwork *pNet, int nPopulation) {
+    m_pNet = pNet;
+    m_nSize = pNet->getGenomSize();
+    double n = m_nSize;
+    m_nPopulation = nPopulation > 0 ? nPopulation : 4 + int(3.0 * std::log(n));
+    m_nPopulation = std::max(m_nPopulation, 2);
+    m_nParents = m_nPopulation / 2;
+
+    // default parameters of CMA-ES, the learning rates of covariance are (n + 2) / 3 times more for sep-CMA-ES
+    double nSum = 0.0;
+    double nSumSquares = 0.0;
+    for (int i = 0; i < m_nParents; ++i) {
+        m_vWeights.push_back(std::log(m_nParents + 0.5) - std::log(i + 1.0));
+        nSum += m_vWeights[i];
+    }
+    for (int i = 0; i < m_nParents; ++i) {
+        m_vWeights[i] /= nSum;
+        nSumSquares += m_vWeights[i] * m_vWeights[i];
+    }
+    m_nMuEff = 1.0 / nSumSquares;
+    m_nCSigma = (m_nMuEff + 2.0) / (n + m_nMuEff + 5.0);
+    m_nDSigma = 1.0 + 2.0 * std::max(0.0, std::sqrt((m_nMuEff - 1.0) / (n + 1.0)) - 1.0) + m_nCSigma;
+    m_nCC = (4.0 + m_nMuEff / n) / (n + 4.0 + 2.0 * m_nMuEff / n);
+    double nC1 = 2.0 / ((n + 1.3) * (n + 1.3) + m_nMuEff);
+    double nCMu = std::min(1.0 - nC1, 2.0 * (m_nMuEff - 2.0 + 1.0 / m_nMuEff) / ((n + 2.0) * (n + 2.0) + m_nMuEff));
+    m_nC1 = std::min(1.0, nC1 * (n + 2.0) / 3.0);
+    m_nCMu = std::min(1.0 - m_nC1, nCMu * (n + 2.0) / 3.0);
+    m_nChiN = std::sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+    m_nRandomSeed = std::rand();
+    m_nGeneration = 0;
+    m_nEvaluations = 0;
+    m_nSigma = 0.1;
+    m_vMean = pNet->getGenom();
+    m_vDiagonal.assign(m_nSize, 1.0);
+    m_vPathSigma.assign(m_nSize, 0.0);
+    m_vPathC.assign(m_nSize, 0.0);
+    m_nBetterRating = std::numeric_limits<float>::infinity();
+}
+
+SimpleNeuralCmaEs::~SimpleNeuralCmaEs() {
+    // defined here, where SimpleNeuralThreadPool is a complete type
+}
+
+void SimpleNeuralCmaEs::setNumberOfThreads(int nThreads) {
+    if (nThreads < 1) {
+        nThreads = SimpleNeuralThreadPool::getDefaultNumberOfThreads();
+    }
+    if (nThreads == 1) {
+        m_pThreadPool.reset();
+    } else {
+        m_pThreadPool.reset(new SimpleNeuralThreadPool(nThreads));
+    }
+}
+
+void SimpleNeuralCmaEs::setRandomSeed(uint64_t nSeed) {
+    m_nRandomSeed = nSeed;
+}
+
+void SimpleNeuralCmaEs::setMean(const std::vector<float> &vWeights) {
+    if (vWeights.size() != m_nSize) {
+        throw std::runtime_error("SimpleNeuralCmaEs: wrong size of genom");
+    }
+    m_vMean = vWeights;
+}
+
+void SimpleNeuralCmaEs::setSigma(float nSigma) {
+    m_nSigma = nSigma;
+}
+
+void SimpleNeuralCmaEs::step(SimpleNeuralTrainingItemList *pTrainingData) {
+    m_vZ.resize((size_t)m_nPopulation * m_nSize);
+    m_vSamples.resize((size_t)m_nPopulation * m_nSize);
+    m_vRatings.resize(m_nPopulation);
+
+    // x = mean + sigma * sqrt(C) * z
+    auto sample = [&](SimpleNeuralNetwork *pNet, int k) {
+        float *pZ = m_vZ.data() + (size_t)k * m_nSize;
+        float *pX = m_vSamples.data() + (size_t)k * m_nSize;
+        SimpleNeuralRandom random(m_nRandomSeed, (uint64_t)m_nGeneration * m_nPopulation + k);
+        random.fillGaussian(pZ, m_nSize);
+        for (int i = 0; i < m_nSize; ++i) {
+            pX[i] = m_vMean[i] + float(m_nSigma * std::sqrt(m_vDiagonal[i])) * pZ[i];
+        }
+        SimpleNeuralGenom genom(pX, m_nSize, 0.0f);
+        genom.calculateRating(pNet, pTrainingData);
+        m_vRatings[k] = genom.getRating();
+    };
+    if (m_pThreadPool) {
+        this->prepareWorkerNets();
+        m_pThreadPool->parallelFor(0, m_nPopulation, [&](int nWorker, int k) {
+            sample(nWorker == 0 ? m_pNet : &m_vWorkerNets[nWorker - 1], k);
+        });
+        for (int i = 0; i < m_vWorkerNets.size(); ++i) {
+            m_pNet->mergeCalcStatistics(m_vWorkerNets[i]);
+        }
+    } else {
+        for (int k = 0; k < m_nPopulation; ++k) {
+            sample(m_pNet, k);
+        }
+    }
+    ++m_nGeneration;
+    m_nEvaluations += m_nPopulation;
+
+    m_vOrder.resize(m_nPopulation);
+    for (int k = 0; k < m_nPopulation; ++k) {
+        m_vOrder[k] = k;
+    }
+    std::sort(m_vOrder.begin(), m_vOrder.end(), [&](int a, int b) {
+        return m_vRatings[a] < m_vRatings[b];
+    });
+    if (m_vRatings[m_vOrder[0]] < m_nBetterRating) {
+        m_nBetterRating = m_vRatings[m_vOrder[0]];
+        const float *pX = m_vSamples.data() + (size_t)m_vOrder[0] * m_nSize;
+        m_vBetterGenom.assign(pX, pX + m_nSize);
+    }
+
+    // the weighted step of parents: z_w and y_w = sqrt(C) * z_w
+    double nNormSigma = 0.0;
+    double nSigmaFactor = std::sqrt(m_nCSigma * (2.0 - m_nCSigma) * m_nMuEff);
+    double nCFactor = std::sqrt(m_nCC * (2.0 - m_nCC) * m_nMuEff);
+    double nHsigmaBound = (1.4 + 2.0 / (m_nSize + 1.0)) * m_nChiN
+        * std::sqrt(1.0 - std::pow(1.0 - m_nCSigma, 2.0 * m_nGeneration));
+    std::vector<double> vYw(m_nSize, 0.0);
+    for (int i = 0; i < m_nSize; ++i) {
+        double nZw = 0.0;
+        for (int r = 0; r < m_nParents; ++r) {
+            nZw += m_vWeights[r] * m_vZ[(size_t)m_vOrder[r] * m_nSize + i];
+        }
+        vYw[i] = std::sqrt(m_vDiagonal[i]) * nZw;
+        m_vMean[i] += float(m_nSigma * vYw[i]);
+        m_vPathSigma[i] = (1.0 - m_nCSigma) * m_vPathSigma[i] + nSigmaFactor * nZw;
+        nNormSigma += m_vPathSigma[i] * m_vPathSigma[i];
+    }
+    nNormSigma = std::sqrt(nNormSigma);
+    double nHsigma = nNormSigma < nHsigmaBound ? 1.0 : 0.0;
+    for (int i = 0; i < m_nSize; ++i) {
+        m_vPathC[i] = (1.0 - m_nCC) * m_vPathC[i] + nHsigma * nCFactor * vYw[i];
+        double nRankMu = 0.0;
+        for (int r = 0; r < m_nParents; ++r) {
+            double z = m_vZ[(size_t)m_vOrder[r] * m_nSize + i];
+            nRankMu += m_vWeights[r] * z * z;
+        }
+        nRankMu *= m_vDiagonal[i];
+        m_vDiagonal[i] = (1.0 - m_nC1 - m_nCMu) * m_vDiagonal[i]
+            + m_nC1 * (m_vPathC[i] * m_vPathC[i] + (1.0 - nHsigma) * m_nCC * (2.0 - m_nCC) * m_vDiagonal[i])
+            + m_nCMu * nRankMu;
+    }
+    m_nSigma *= std::exp((m_nCSigma / m_nDSigma) * (nNormSigma / m_nChiN - 1.0));
+}
+
+int SimpleNeuralCmaEs::getPopulation() const {
+    return m_nPopulation;
+}
+
+long long SimpleNeuralCmaEs::getGeneration() const {
+    return m_nGeneration;
+}
+
+long long SimpleNeuralCmaEs::getNumberOfEvaluations() const {
+    return m_nEvaluations;
+}
+
+float SimpleNeuralCmaEs::getSigma() const {
+    return m_nSigma;
+}
+
+const std::vector<float> &SimpleNeuralCmaEs::getMean() const {
+    return m_vMean;
+}
+
+float SimpleNeuralCmaEs::getBetterRating() const {
+    return m_nBetterRating;
+}
+
+const std::vector<float> &SimpleNeuralCmaEs::getBetterGenom() const {
+    return m_vBetterGenom;
+}
+
+void SimpleNeuralCmaEs::prepareWorkerNets() {
+    int nThreads = m_pThreadPool->getNumberOfThreads();
+    if (m_vWorkerNets.size() != nThreads - 1) {
+        m_vWorkerNets.clear();
+        m_vWorkerNets.reserve(nThreads - 1);
+        for (int i = 1; i < nThreads; ++i) {
+            m_vWorkerNets.emplace_back(*m_pNet);
+        }
+    }
+    // the loss can be changed after the copy
+    for (int i = 0; i < m_vWorkerNets.size(); ++i) {
+        m_vWorkerNets[i].setLoss(m_pNet->getLoss());
+    }
+}
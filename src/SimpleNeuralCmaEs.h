@@ -0,0 +1,98 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_CMA_ES_H__
+#define __SIMPLE_NEURAL_CMA_ES_H__
+
+#include <vector>
+#include <memory>
+#include <stdint.h>
+
+class SimpleNeuralNetwork;
+class SimpleNeuralTrainingItemList;
+class SimpleNeuralThreadPool;
+
+// Separable CMA-ES (Ros & Hansen, 2008): covariance matrix adaptation
+// with the diagonal covariance, so the memory and the update are O(genom size)
+// and it works for genoms of tens of thousands of weights.
+// The fitness is the rating of SimpleNeuralGenom, samples are generated and rated in parallel,
+// every sample has own random stream (seed, generation, number of sample).
+class SimpleNeuralCmaEs {
+    public:
+        // nPopulation: 0 - 4 + 3 * ln(genom size)
+        SimpleNeuralCmaEs(SimpleNeuralNetwork *pNet, int nPopulation = 0);
+        ~SimpleNeuralCmaEs();
+        void setNumberOfThreads(int nThreads); // 0 - all hardware threads, 1 - serial (default)
+        void setRandomSeed(uint64_t nSeed);
+        void setMean(const std::vector<float> &vWeights); // the start, the genom of the network by default
+        void setSigma(float nSigma); // the start step size, 0.1 by default
+
+        // one generation: samples, ratings and update of the distribution
+        void step(SimpleNeuralTrainingItemList *pTrainingData);
+
+        int getPopulation() const;
+        long long getGeneration() const;
+        long long getNumberOfEvaluations() const;
+        float getSigma() const;
+        const std::vector<float> &getMean() const;
+        float getBetterRating() const; // of all rated samples
+        const std::vector<float> &getBetterGenom() const;
+
+    private:
+        void prepareWorkerNets();
+
+        SimpleNeuralNetwork *m_pNet;
+        int m_nSize;
+        int m_nPopulation;
+        int m_nParents;
+        std::vector<double> m_vWeights; // of the parents by rank
+        double m_nMuEff;
+        double m_nCSigma;
+        double m_nDSigma;
+        double m_nCC;
+        double m_nC1;
+        double m_nCMu;
+        double m_nChiN; // expectation of |N(0, I)|
+
+        uint64_t m_nRandomSeed;
+        long long m_nGeneration;
+        long long m_nEvaluations;
+        double m_nSigma;
+        std::vector<float> m_vMean;
+        std::vector<double> m_vDiagonal; // C
+        std::vector<double> m_vPathSigma;
+        std::vector<double> m_vPathC;
+
+        std::vector<float> m_vZ; // [sample][weight] N(0, I)
+        std::vector<float> m_vSamples; // [sample][weight]
+        std::vector<float> m_vRatings;
+        std::vector<int> m_vOrder;
+        float m_nBetterRating;
+        std::vector<float> m_vBetterGenom;
+
+        std::unique_ptr<SimpleNeuralThreadPool> m_pThreadPool;
+        std::vector<SimpleNeuralNetwork> m_vWorkerNets;
+};
+
+#endif // __SIMPLE_NEURAL_CMA_ES_H__
@@ -0,0 +1,307 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralDeltaEvaluator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <math.h>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralDeltaEvaluator
+
+SimpleNeuralDeltaEvaluator::SimpleNeuralDeltaEvaluator(
+    SimpleNeuralNetwork *pNet,
+    SimpleNeuralTrainingItemList *pTrainingData
+)
+    : m_pNet(pNet)
+    , m_pTrainingData(pTrainingData)
+    , m_vLayers(pNet->getLayers())
+    , m_nDeltaCounter(0)
+    , m_nFullCounter(0)
+{
+    if (pNet->getLoss() != SimpleNeuralLoss::Euclidean) {
+        throw std::runtime_error("SimpleNeuralDeltaEvaluator: only Euclidean loss is supported");
+    }
+    m_nInputSize = m_vLayers[0];
+    m_nOutputSize = m_vLayers.back();
+    m_nGenomSize = pNet->getGenomSize();
+    m_nSamples = pTrainingData->size();
+    m_nDenseThreshold = 0.5f;
+
+    m_vLayerOffsets.push_back(0);
+    int nOffset = m_nInputSize;
+    for (int nL = 1; nL < m_vLayers.size(); ++nL) {
+        m_vLayerOffsets.push_back(nOffset);
+        nOffset += m_vLayers[nL - 1] * m_vLayers[nL];
+    }
+
+    for (auto it = pTrainingData->begin(); it != pTrainingData->end(); ++it) {
+        const std::vector<float> &vIn = it->getIn();
+        const std::vector<float> &vOut = it->getOut();
+        m_vPackedInputs.insert(m_vPackedInputs.end(), vIn.begin(), vIn.end());
+        m_vExpected.insert(m_vExpected.end(), vOut.begin(), vOut.end());
+    }
+    this->setNumberOfWorkers(1);
+}
+
+void SimpleNeuralDeltaEvaluator::setNumberOfWorkers(int nWorkers) {
+    nWorkers = std::max(1, nWorkers);
+    while (m_vWorkerNets.size() < nWorkers) {
+        m_vWorkerNets.emplace_back(*m_pNet);
+        // the delta is only Euclidean, the full rating too (the loss of the net can be changed later)
+        m_vWorkerNets.back().setLoss(SimpleNeuralLoss::Euclidean);
+    }
+    m_vScratch.resize(nWorkers);
+    for (int i = 0; i < nWorkers; ++i) {
+        Scratch &scratch = m_vScratch[i];
+        scratch.vChanged.reserve(m_nGenomSize);
+        scratch.vDownstream.resize(m_vLayers.size());
+        for (int nL = 0; nL < m_vLayers.size(); ++nL) {
+            scratch.vDownstream[nL].resize(m_nOutputSize * m_vLayers[nL]);
+        }
+        scratch.vDelta.resize(m_nOutputSize * m_nInputSize);
+    }
+}
+
+void SimpleNeuralDeltaEvaluator::setDenseThreshold(float nRatio) {
+    m_nDenseThreshold = nRatio;
+}
+
+void SimpleNeuralDeltaEvaluator::setParents(const std::vector<const float *> &vParents) {
+    std::vector<ParentCache> vOld;
+    vOld.swap(m_vParents);
+    for (int i = 0; i < vParents.size(); ++i) {
+        bool bFound = false;
+        for (int j = 0; j < m_vParents.size(); ++j) {
+            bFound = bFound || m_vParents[j].pWeights == vParents[i];
+        }
+        if (bFound) {
+            continue;
+        }
+        // keep the cache if the row was not rewritten
+        ParentCache cache;
+        cache.pWeights = vParents[i];
+        cache.bReady = false;
+        for (int j = 0; j < vOld.size(); ++j) {
+            if (vOld[j].pWeights == vParents[i] && vOld[j].bReady
+                && std::memcmp(vOld[j].vWeights.data(), vParents[i], m_nGenomSize * sizeof(float)) == 0
+            ) {
+                cache = std::move(vOld[j]);
+                break;
+            }
+        }
+        m_vParents.push_back(std::move(cache));
+    }
+}
+
+int SimpleNeuralDeltaEvaluator::getNumberOfParents() const {
+    return m_vParents.size();
+}
+
+void SimpleNeuralDeltaEvaluator::prepareParent(int nParent, int nWorker) {
+    ParentCache &cache = m_vParents[nParent];
+    if (cache.bReady) {
+        return;
+    }
+    const float *pWeights = cache.pWeights;
+    cache.vWeights.assign(pWeights, pWeights + m_nGenomSize);
+
+    // outputs for every training item
+    SimpleNeuralNetwork &net = m_vWorkerNets[nWorker];
+    cache.vOutputs.resize(m_nSamples * m_nOutputSize);
+    int nSample = 0;
+    for (auto it = m_pTrainingData->begin(); it != m_pTrainingData->end(); ++it) {
+        const std::vector<float> &vOut = net.calc(pWeights, it->getIn());
+        std::copy(vOut.begin(), vOut.end(), cache.vOutputs.begin() + nSample * m_nOutputSize);
+        ++nSample;
+    }
+
+    // P_0 = diag(w_0), P_l = W_l * P_(l-1)
+    int nLayers = m_vLayers.size();
+    cache.vPrefix.resize(nLayers - 1);
+    std::vector<double> &vFirst = cache.vPrefix[0];
+    vFirst.assign(m_nInputSize * m_nInputSize, 0.0);
+    for (int i = 0; i < m_nInputSize; ++i) {
+        vFirst[i * m_nInputSize + i] = pWeights[i];
+    }
+    for (int nL = 1; nL < nLayers - 1; ++nL) {
+        int nPrevLayerSize = m_vLayers[nL - 1];
+        int nLayerSize = m_vLayers[nL];
+        const std::vector<double> &vPrev = cache.vPrefix[nL - 1];
+        std::vector<double> &vCurr = cache.vPrefix[nL];
+        vCurr.assign(nLayerSize * m_nInputSize, 0.0);
+        const float *pW = pWeights + m_vLayerOffsets[nL];
+        for (int nN = 0; nN < nLayerSize; ++nN) {
+            double *pRow = vCurr.data() + nN * m_nInputSize;
+            for (int nP = 0; nP < nPrevLayerSize; ++nP) {
+                double nWeight = pW[nN * nPrevLayerSize + nP];
+                const double *pPrevRow = vPrev.data() + nP * m_nInputSize;
+                for (int i = 0; i < m_nInputSize; ++i) {
+                    pRow[i] += nWeight * pPrevRow[i];
+                }
+            }
+        }
+    }
+    cache.bReady = true;
+}
+
+void SimpleNeuralDeltaEvaluator::calculateRating(SimpleNeuralGenom &genom, const float *pParent, int nWorker) {
+    const ParentCache *pCache = nullptr;
+    for (int i = 0; i < m_vParents.size() && pParent != nullptr; ++i) {
+        if (m_vParents[i].pWeights == pParent && m_vParents[i].bReady) {
+            pCache = &m_vParents[i];
+        }
+    }
+    if (pCache == nullptr) {
+        this->calculateRatingFull(genom, nWorker);
+        return;
+    }
+
+    Scratch &scratch = m_vScratch[nWorker];
+    const float *pChild = genom.getWeights();
+    const float *pBase = pCache->vWeights.data();
+    scratch.vChanged.clear();
+    for (int i = 0; i < m_nGenomSize; ++i) {
+        if (pChild[i] != pBase[i]) {
+            scratch.vChanged.push_back(i);
+        }
+    }
+
+    // the lowest changed layer
+    int nLayers = m_vLayers.size();
+    int nLowest = nLayers - 1;
+    if (!scratch.vChanged.empty()) {
+        int nFirstChanged = scratch.vChanged[0];
+        nLowest = 0;
+        while (nLowest + 1 < nLayers && m_vLayerOffsets[nLowest + 1] <= nFirstChanged) {
+            ++nLowest;
+        }
+    }
+
+    // is it cheaper than the full pass?
+    double nDeltaCost = double(scratch.vChanged.size() + m_nSamples) * m_nInputSize * m_nOutputSize;
+    for (int nL = nLowest + 1; nL < nLayers; ++nL) {
+        nDeltaCost += double(m_nOutputSize) * m_vLayers[nL] * m_vLayers[nL - 1];
+    }
+    double nFullCost = double(m_nSamples) * m_nGenomSize;
+    if (nDeltaCost > m_nDenseThreshold * nFullCost) {
+        this->calculateRatingFull(genom, nWorker);
+        return;
+    }
+
+    // J_K = I, J_l = J_(l+1) * W_(l+1) of the child
+    std::vector<double> &vLast = scratch.vDownstream[nLayers - 1];
+    std::fill(vLast.begin(), vLast.end(), 0.0);
+    for (int o = 0; o < m_nOutputSize; ++o) {
+        vLast[o * m_nOutputSize + o] = 1.0;
+    }
+    for (int nL = nLayers - 2; nL >= nLowest; --nL) {
+        int nLayerSize = m_vLayers[nL];
+        int nNextLayerSize = m_vLayers[nL + 1];
+        const std::vector<double> &vNext = scratch.vDownstream[nL + 1];
+        std::vector<double> &vCurr = scratch.vDownstream[nL];
+        std::fill(vCurr.begin(), vCurr.end(), 0.0);
+        const float *pW = pChild + m_vLayerOffsets[nL + 1];
+        for (int o = 0; o < m_nOutputSize; ++o) {
+            double *pRow = vCurr.data() + o * nLayerSize;
+            for (int nN = 0; nN < nNextLayerSize; ++nN) {
+                double nJ = vNext[o * nNextLayerSize + nN];
+                const float *pWRow = pW + nN * nLayerSize;
+                for (int nP = 0; nP < nLayerSize; ++nP) {
+                    pRow[nP] += nJ * pWRow[nP];
+                }
+            }
+        }
+    }
+
+    // D = sum of J_l * dW_l * P_(l-1)
+    std::vector<double> &vDelta = scratch.vDelta;
+    std::fill(vDelta.begin(), vDelta.end(), 0.0);
+    int nLayer = 0;
+    for (int c = 0; c < scratch.vChanged.size(); ++c) {
+        int nIndex = scratch.vChanged[c];
+        while (nLayer + 1 < nLayers && m_vLayerOffsets[nLayer + 1] <= nIndex) {
+            ++nLayer;
+        }
+        double nDiff = double(pChild[nIndex]) - double(pBase[nIndex]);
+        const std::vector<double> &vJ = scratch.vDownstream[nLayer];
+        int nLayerSize = m_vLayers[nLayer];
+        if (nLayer == 0) {
+            // input weights: diagonal
+            for (int o = 0; o < m_nOutputSize; ++o) {
+                vDelta[o * m_nInputSize + nIndex] += nDiff * vJ[o * nLayerSize + nIndex];
+            }
+            continue;
+        }
+        int nPrevLayerSize = m_vLayers[nLayer - 1];
+        int nN = (nIndex - m_vLayerOffsets[nLayer]) / nPrevLayerSize;
+        int nP = (nIndex - m_vLayerOffsets[nLayer]) % nPrevLayerSize;
+        const double *pPrefixRow = pCache->vPrefix[nLayer - 1].data() + nP * m_nInputSize;
+        for (int o = 0; o < m_nOutputSize; ++o) {
+            double nK = nDiff * vJ[o * nLayerSize + nN];
+            double *pDeltaRow = vDelta.data() + o * m_nInputSize;
+            for (int i = 0; i < m_nInputSize; ++i) {
+                pDeltaRow[i] += nK * pPrefixRow[i];
+            }
+        }
+    }
+
+    // out_child = out_parent + D * in
+    float nSumDiffs = 0.0f;
+    for (int s = 0; s < m_nSamples; ++s) {
+        const float *pIn = m_vPackedInputs.data() + s * m_nInputSize;
+        const float *pOutParent = pCache->vOutputs.data() + s * m_nOutputSize;
+        const float *pExpected = m_vExpected.data() + s * m_nOutputSize;
+        float ret = 0;
+        for (int o = 0; o < m_nOutputSize; ++o) {
+            const double *pDeltaRow = vDelta.data() + o * m_nInputSize;
+            double nOut = pOutParent[o];
+            for (int i = 0; i < m_nInputSize; ++i) {
+                nOut += pDeltaRow[i] * pIn[i];
+            }
+            float x1 = float(nOut);
+            float x2 = pExpected[o];
+            ret += (x2 - x1)*(x2 - x1);
+        }
+        ret = std::sqrt(ret);
+        nSumDiffs += ret;
+    }
+    genom.setRating(nSumDiffs / float(m_nSamples));
+    ++m_nDeltaCounter;
+}
+
+void SimpleNeuralDeltaEvaluator::calculateRatingFull(SimpleNeuralGenom &genom, int nWorker) {
+    genom.calculateRating(&m_vWorkerNets[nWorker], m_pTrainingData);
+    ++m_nFullCounter;
+}
+
+long long SimpleNeuralDeltaEvaluator::getDeltaCounter() const {
+    return m_nDeltaCounter;
+}
+
+long long SimpleNeuralDeltaEvaluator::getFullCounter() const {
+    return m_nFullCounter;
+}
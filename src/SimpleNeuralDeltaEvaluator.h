@@ -0,0 +1,96 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_DELTA_EVALUATOR_H__
+#define __SIMPLE_NEURAL_DELTA_EVALUATOR_H__
+
+#include <vector>
+#include <atomic>
+
+#include "SimpleNeuralNetwork.h"
+
+// Rates a child by the difference from its parent (incremental rating).
+// The network has no activation functions, so it is linear: out = W_K * ... * W_1 * diag(w_0) * in.
+// For every parent the cache keeps its outputs for every training item and
+// the maps from the input to every hidden layer (P_l = W_l * ... * diag(w_0)),
+// it's the same as the activations of every sample, but does not grow with number of samples.
+// If child differs from parent by weights dW, then (exactly, by telescoping)
+//     out_child - out_parent = sum_l J_l * dW_l * P_(l-1) * in = D * in
+// where J_l = W_K(child) * ... * W_(l+1)(child). D has size out x in,
+// so the rating of the child costs O(changed weights * in * out + samples * in * out).
+// If a lot of weights are changed, genom is rated by the full pass over training data.
+// Only the Euclidean loss is supported.
+class SimpleNeuralDeltaEvaluator {
+    public:
+        SimpleNeuralDeltaEvaluator(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData);
+
+        void setNumberOfWorkers(int nWorkers);
+        // use delta only if it's cheaper than nRatio * (full pass), default 0.5
+        void setDenseThreshold(float nRatio);
+
+        // parents of next children, cache is kept only for them
+        void setParents(const std::vector<const float *> &vParents);
+        int getNumberOfParents() const;
+        void prepareParent(int nParent, int nWorker = 0);
+
+        // pParent must be one of setParents() or nullptr (full pass)
+        void calculateRating(SimpleNeuralGenom &genom, const float *pParent, int nWorker = 0);
+
+        long long getDeltaCounter() const;
+        long long getFullCounter() const;
+
+    private:
+        struct ParentCache {
+            const float *pWeights;
+            bool bReady;
+            std::vector<float> vWeights; // copy, the row in arena can be rewritten later
+            std::vector<float> vOutputs; // [sample][out]
+            std::vector<std::vector<double>> vPrefix; // P_l, [n_l][in], l = 0 .. K-1
+        };
+        struct Scratch {
+            std::vector<int> vChanged;
+            std::vector<std::vector<double>> vDownstream; // J_l, [out][n_l]
+            std::vector<double> vDelta; // D, [out][in]
+        };
+        void calculateRatingFull(SimpleNeuralGenom &genom, int nWorker);
+
+        SimpleNeuralNetwork *m_pNet;
+        SimpleNeuralTrainingItemList *m_pTrainingData;
+        std::vector<int> m_vLayers;
+        std::vector<int> m_vLayerOffsets; // first weight of every layer
+        int m_nInputSize;
+        int m_nOutputSize;
+        int m_nGenomSize;
+        int m_nSamples;
+        float m_nDenseThreshold;
+        std::vector<float> m_vExpected; // [sample][out]
+        std::vector<float> m_vPackedInputs; // [sample][in]
+        std::vector<ParentCache> m_vParents;
+        std::vector<SimpleNeuralNetwork> m_vWorkerNets;
+        std::vector<Scratch> m_vScratch;
+        std::atomic<long long> m_nDeltaCounter;
+        std::atomic<long long> m_nFullCounter;
+};
+
+#endif // __SIMPLE_NEURAL_DELTA_EVALUATOR_H__
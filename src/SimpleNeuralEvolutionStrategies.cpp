@@ -0,0 +1,228 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralEvolutionStrategies.h"
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralThreadPool.h"
+#include "SimpleNeuralRandom.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+// the perturbation is generated by blocks, so the update can be split by weights
+static const int BLOCK_WEIGHTS = 1024;
+
+// ---------------------------------------------------------------------
+// SimpleNeuralEvolutionStrategies
+
+SimpleNeuralEvolutionStrategies::SimpleNeuralEvolutionStrategies(SimpleNeuralNetwork *pNet, int nPairs) {
+    if (nPairs < 1) {
+        throw std::runtime_error("SimpleNeuralEvolutionStrategies: number of pairs must be positive");
+    }
+    m_pNet = pNet;
+    m_nSize = pNet->getGenomSize();
+    m_nPairs = nPairs;
+    m_nBlocks = (m_nSize + BLOCK_WEIGHTS - 1) / BLOCK_WEIGHTS;
+    m_nRandomSeed = std::rand();
+    m_nSigma = 0.02f;
+    m_nLearningRate = 0.001f;
+    m_nGeneration = 0;
+    m_nBetterRating = std::numeric_limits<float>::infinity();
+    m_vParameters = pNet->getGenom();
+}
+
+SimpleNeuralEvolutionStrategies::~SimpleNeuralEvolutionStrategies() {
+    // defined here, where SimpleNeuralThreadPool is a complete type
+}
+
+void SimpleNeuralEvolutionStrategies::setNumberOfThreads(int nThreads) {
+    if (nThreads < 1) {
+        nThreads = SimpleNeuralThreadPool::getDefaultNumberOfThreads();
+    }
+    if (nThreads == 1) {
+        m_pThreadPool.reset();
+    } else {
+        m_pThreadPool.reset(new SimpleNeuralThreadPool(nThreads));
+    }
+}
+
+void SimpleNeuralEvolutionStrategies::setRandomSeed(uint64_t nSeed) {
+    m_nRandomSeed = nSeed;
+}
+
+void SimpleNeuralEvolutionStrategies::setSigma(float nSigma) {
+    m_nSigma = nSigma;
+}
+
+void SimpleNeuralEvolutionStrategies::setLearningRate(float nLearningRate) {
+    m_nLearningRate = nLearningRate;
+}
+
+void SimpleNeuralEvolutionStrategies::setParameters(const std::vector<float> &vWeights) {
+    if (vWeights.size() != m_nSize) {
+        throw std::runtime_error("SimpleNeuralEvolutionStrategies: wrong size of genom");
+    }
+    m_vParameters = vWeights;
+}
+
+const std::vector<float> &SimpleNeuralEvolutionStrategies::getParameters() const {
+    return m_vParameters;
+}
+
+void SimpleNeuralEvolutionStrategies::ratePairs(SimpleNeuralTrainingItemList *pTrainingData, int nBegin, int nEnd, float *pRatings) {
+    if (nBegin < 0 || nEnd > m_nPairs || nBegin > nEnd) {
+        throw std::runtime_error("SimpleNeuralEvolutionStrategies: wrong range of pairs");
+    }
+    this->prepareWorkers();
+    auto ratePair = [&](int nWorker, int j) {
+        SimpleNeuralNetwork *pNet = nWorker == 0 ? m_pNet : &m_vWorkerNets[nWorker - 1];
+        float *pEpsilon = m_vWorkerEpsilons[nWorker].data();
+        float *pSample = m_vWorkerSamples[nWorker].data();
+        for (int b = 0; b < m_nBlocks; ++b) {
+            this->perturbation(j, b, pEpsilon + b * BLOCK_WEIGHTS);
+        }
+        for (int nSign = 0; nSign < 2; ++nSign) {
+            float nSigma = nSign == 0 ? m_nSigma : -m_nSigma;
+            for (int i = 0; i < m_nSize; ++i) {
+                pSample[i] = m_vParameters[i] + nSigma * pEpsilon[i];
+            }
+            SimpleNeuralGenom genom(pSample, m_nSize, 0.0f);
+            genom.calculateRating(pNet, pTrainingData);
+            pRatings[2 * j + nSign] = genom.getRating();
+        }
+    };
+    if (m_pThreadPool) {
+        m_pThreadPool->parallelFor(nBegin, nEnd, ratePair);
+        for (int i = 0; i < m_vWorkerNets.size(); ++i) {
+            m_pNet->mergeCalcStatistics(m_vWorkerNets[i]);
+        }
+    } else {
+        for (int j = nBegin; j < nEnd; ++j) {
+            ratePair(0, j);
+        }
+    }
+}
+
+void SimpleNeuralEvolutionStrategies::update(const float *pRatings) {
+    int nSamples = 2 * m_nPairs;
+
+    // centered ranks in [-0.5, 0.5], the least rating is the best
+    m_vOrder.resize(nSamples);
+    for (int k = 0; k < nSamples; ++k) {
+        m_vOrder[k] = k;
+    }
+    std::stable_sort(m_vOrder.begin(), m_vOrder.end(), [&](int a, int b) {
+        return pRatings[a] < pRatings[b];
+    });
+    m_nBetterRating = pRatings[m_vOrder[0]];
+    std::vector<float> vUtility(nSamples, 0.0f);
+    for (int r = 0; r < nSamples; ++r) {
+        vUtility[m_vOrder[r]] = nSamples > 1 ? 0.5f - float(r) / (nSamples - 1) : 0.0f;
+    }
+    m_vUtilities.resize(m_nPairs);
+    for (int j = 0; j < m_nPairs; ++j) {
+        m_vUtilities[j] = vUtility[2 * j] - vUtility[2 * j + 1];
+    }
+
+    // theta += lr / (2 * pairs * sigma) * sum((u+ - u-) * epsilon), every block sums the pairs in the same order
+    this->prepareWorkers();
+    m_vGradient.resize(m_nSize);
+    float nFactor = m_nLearningRate / (nSamples * m_nSigma);
+    auto updateBlock = [&](int nWorker, int b) {
+        float *pEpsilon = m_vWorkerEpsilons[nWorker].data();
+        float *pGradient = m_vGradient.data() + b * BLOCK_WEIGHTS;
+        int nBlockSize = this->getBlockSize(b);
+        std::fill(pGradient, pGradient + nBlockSize, 0.0f);
+        for (int j = 0; j < m_nPairs; ++j) {
+            this->perturbation(j, b, pEpsilon);
+            float u = m_vUtilities[j];
+            for (int i = 0; i < nBlockSize; ++i) {
+                pGradient[i] += u * pEpsilon[i];
+            }
+        }
+        float *pParameters = m_vParameters.data() + b * BLOCK_WEIGHTS;
+        for (int i = 0; i < nBlockSize; ++i) {
+            pParameters[i] += nFactor * pGradient[i];
+        }
+    };
+    if (m_pThreadPool) {
+        m_pThreadPool->parallelFor(0, m_nBlocks, updateBlock);
+    } else {
+        for (int b = 0; b < m_nBlocks; ++b) {
+            updateBlock(0, b);
+        }
+    }
+    ++m_nGeneration;
+}
+
+void SimpleNeuralEvolutionStrategies::step(SimpleNeuralTrainingItemList *pTrainingData) {
+    m_vRatings.resize(2 * m_nPairs);
+    this->ratePairs(pTrainingData, 0, m_nPairs, m_vRatings.data());
+    this->update(m_vRatings.data());
+}
+
+int SimpleNeuralEvolutionStrategies::getNumberOfPairs() const {
+    return m_nPairs;
+}
+
+long long SimpleNeuralEvolutionStrategies::getGeneration() const {
+    return m_nGeneration;
+}
+
+float SimpleNeuralEvolutionStrategies::getBetterRating() const {
+    return m_nBetterRating;
+}
+
+void SimpleNeuralEvolutionStrategies::perturbation(int nPair, int nBlock, float *pEpsilon) const {
+    uint64_t nStream = ((uint64_t)m_nGeneration * m_nPairs + nPair) * m_nBlocks + nBlock;
+    SimpleNeuralRandom random(m_nRandomSeed, nStream);
+    random.fillGaussian(pEpsilon, this->getBlockSize(nBlock));
+}
+
+int SimpleNeuralEvolutionStrategies::getBlockSize(int nBlock) const {
+    return std::min(BLOCK_WEIGHTS, m_nSize - nBlock * BLOCK_WEIGHTS);
+}
+
+void SimpleNeuralEvolutionStrategies::prepareWorkers() {
+    int nThreads = m_pThreadPool ? m_pThreadPool->getNumberOfThreads() : 1;
+    if (m_vWorkerNets.size() != nThreads - 1) {
+        m_vWorkerNets.clear();
+        m_vWorkerNets.reserve(nThreads - 1);
+        for (int i = 1; i < nThreads; ++i) {
+            m_vWorkerNets.emplace_back(*m_pNet);
+        }
+    }
+    // the loss can be changed after the copy
+    for (int i = 0; i < m_vWorkerNets.size(); ++i) {
+        m_vWorkerNets[i].setLoss(m_pNet->getLoss());
+    }
+    m_vWorkerSamples.resize(nThreads);
+    m_vWorkerEpsilons.resize(nThreads);
+    for (int i = 0; i < nThreads; ++i) {
+        m_vWorkerSamples[i].resize(m_nSize);
+        m_vWorkerEpsilons[i].resize((size_t)m_nBlocks * BLOCK_WEIGHTS);
+    }
+}
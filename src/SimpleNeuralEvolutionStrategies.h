@@ -0,0 +1,95 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_EVOLUTION_STRATEGIES_H__
+#define __SIMPLE_NEURAL_EVOLUTION_STRATEGIES_H__
+
+#include <vector>
+#include <memory>
+#include <stdint.h>
+
+class SimpleNeuralNetwork;
+class SimpleNeuralTrainingItemList;
+class SimpleNeuralThreadPool;
+
+// Evolution strategies with shared seeds (Salimans et al., 2017).
+// Perturbation j of the generation is N(0, I) from the streams (seed, generation, j, block),
+// so every worker can build it again: workers exchange only ratings, never weights.
+// The update is deterministic and does not depend on the number of threads.
+// Mirrored sampling: every perturbation is rated with both signs.
+// The gradient is estimated from centered ranks of ratings.
+//
+// In several processes: every process has the same parameters and seed,
+// rates its part of pairs (ratePairs), ratings of all pairs are exchanged
+// and every process applies update() - the parameters stay the same everywhere.
+class SimpleNeuralEvolutionStrategies {
+    public:
+        SimpleNeuralEvolutionStrategies(SimpleNeuralNetwork *pNet, int nPairs);
+        ~SimpleNeuralEvolutionStrategies();
+        void setNumberOfThreads(int nThreads); // 0 - all hardware threads, 1 - serial (default)
+        void setRandomSeed(uint64_t nSeed);
+        void setSigma(float nSigma); // 0.02 by default
+        void setLearningRate(float nLearningRate); // 0.001 by default
+        void setParameters(const std::vector<float> &vWeights); // the genom of the network by default
+        const std::vector<float> &getParameters() const;
+
+        // rates pairs [nBegin, nEnd) of the current generation on the threads:
+        // pRatings[2 * j] with +sigma, pRatings[2 * j + 1] with -sigma (pRatings has 2 * nPairs values)
+        void ratePairs(SimpleNeuralTrainingItemList *pTrainingData, int nBegin, int nEnd, float *pRatings);
+        // 2 * nPairs ratings of all pairs, moves to the next generation
+        void update(const float *pRatings);
+        // ratePairs for all pairs on the threads and update
+        void step(SimpleNeuralTrainingItemList *pTrainingData);
+
+        int getNumberOfPairs() const;
+        long long getGeneration() const;
+        float getBetterRating() const; // of the samples of the last generation
+
+    private:
+        void perturbation(int nPair, int nBlock, float *pEpsilon) const;
+        int getBlockSize(int nBlock) const;
+        void prepareWorkers();
+
+        SimpleNeuralNetwork *m_pNet;
+        int m_nSize;
+        int m_nPairs;
+        int m_nBlocks;
+        uint64_t m_nRandomSeed;
+        float m_nSigma;
+        float m_nLearningRate;
+        long long m_nGeneration;
+        float m_nBetterRating;
+        std::vector<float> m_vParameters;
+        std::vector<float> m_vRatings; // of all pairs in step()
+        std::vector<float> m_vUtilities; // of pairs: utility(+sigma) - utility(-sigma)
+        std::vector<int> m_vOrder;
+        std::vector<float> m_vGradient;
+
+        std::unique_ptr<SimpleNeuralThreadPool> m_pThreadPool;
+        std::vector<SimpleNeuralNetwork> m_vWorkerNets;
+        std::vector<std::vector<float>> m_vWorkerSamples;
+        std::vector<std::vector<float>> m_vWorkerEpsilons;
+};
+
+#endif // __SIMPLE_NEURAL_EVOLUTION_STRATEGIES_H__
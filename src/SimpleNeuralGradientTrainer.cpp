@@ -0,0 +1,273 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralGradientTrainer.h"
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralRandom.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cstdlib>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralGradientTrainer
+
+SimpleNeuralGradientTrainer::SimpleNeuralGradientTrainer(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData) {
+    m_vLayers = pNet->getLayers();
+    m_nGenomSize = pNet->getGenomSize();
+    m_nInputSize = m_vLayers.front();
+    m_nOutputSize = m_vLayers.back();
+    if (pTrainingData->getNumberOfIn() != m_nInputSize || pTrainingData->getNumberOfOut() != m_nOutputSize) {
+        throw std::runtime_error("SimpleNeuralGradientTrainer: training data does not match the network");
+    }
+    m_pTrainingData = pTrainingData;
+
+    m_nSignalsSize = 0;
+    int nWeights = m_nInputSize;
+    for (int l = 0; l < m_vLayers.size(); ++l) {
+        m_vSignalOffsets.push_back(m_nSignalsSize);
+        m_nSignalsSize += m_vLayers[l];
+        m_vWeightOffsets.push_back(l == 0 ? 0 : nWeights);
+        if (l > 0) {
+            nWeights += m_vLayers[l] * m_vLayers[l - 1];
+        }
+    }
+
+    m_nOptimizer = SimpleNeuralOptimizer::Adam;
+    m_nLearningRate = 0.001f;
+    m_nMomentum = 0.9f;
+    m_nBeta1 = 0.9f;
+    m_nBeta2 = 0.999f;
+    m_nEpsilon = 1e-8f;
+    m_nBatchSize = 32;
+    m_nRandomSeed = std::rand();
+    m_nEpoch = 0;
+    m_nSteps = 0;
+    m_vGradient.assign(m_nGenomSize, 0.0f);
+    m_vVelocity.assign(m_nGenomSize, 0.0f);
+    m_vSecondMoment.assign(m_nGenomSize, 0.0f);
+}
+
+void SimpleNeuralGradientTrainer::setOptimizer(SimpleNeuralOptimizer nOptimizer) {
+    m_nOptimizer = nOptimizer;
+    // the state of the other optimizer means nothing
+    m_nSteps = 0;
+    m_vVelocity.assign(m_nGenomSize, 0.0f);
+    m_vSecondMoment.assign(m_nGenomSize, 0.0f);
+}
+
+void SimpleNeuralGradientTrainer::setLearningRate(float nLearningRate) {
+    m_nLearningRate = nLearningRate;
+}
+
+void SimpleNeuralGradientTrainer::setMomentum(float nMomentum) {
+    m_nMomentum = nMomentum;
+}
+
+void SimpleNeuralGradientTrainer::setAdam(float nBeta1, float nBeta2, float nEpsilon) {
+    m_nBeta1 = nBeta1;
+    m_nBeta2 = nBeta2;
+    m_nEpsilon = nEpsilon;
+}
+
+void SimpleNeuralGradientTrainer::setBatchSize(int nBatchSize) {
+    m_nBatchSize = std::max(1, nBatchSize);
+}
+
+void SimpleNeuralGradientTrainer::setRandomSeed(uint64_t nSeed) {
+    m_nRandomSeed = nSeed;
+}
+
+float SimpleNeuralGradientTrainer::trainEpoch(float *pWeights) {
+    int nSize = m_pTrainingData->size();
+    if (nSize == 0) {
+        return 0.0f;
+    }
+    m_vOrder.resize(nSize);
+    for (int i = 0; i < nSize; ++i) {
+        m_vOrder[i] = i;
+    }
+    SimpleNeuralRandom random(m_nRandomSeed, m_nEpoch);
+    for (int i = nSize - 1; i > 0; --i) {
+        std::swap(m_vOrder[i], m_vOrder[random.nextInt(i + 1)]);
+    }
+    ++m_nEpoch;
+
+    double nSumLoss = 0.0;
+    int nBatches = 0;
+    for (int nBegin = 0; nBegin < nSize; nBegin += m_nBatchSize) {
+        int nCount = std::min(m_nBatchSize, nSize - nBegin);
+        std::fill(m_vGradient.begin(), m_vGradient.end(), 0.0f);
+        float nLoss = this->forwardBackward(pWeights, m_vOrder.data() + nBegin, nCount, m_vGradient.data());
+        float nScale = 1.0f / nCount;
+        for (int i = 0; i < m_nGenomSize; ++i) {
+            m_vGradient[i] *= nScale;
+        }
+        this->applyGradient(pWeights);
+        nSumLoss += nLoss * nScale;
+        ++nBatches;
+    }
+    return nSumLoss / nBatches;
+}
+
+float SimpleNeuralGradientTrainer::calculateGradient(const float *pWeights, std::vector<float> &vGradient) {
+    int nSize = m_pTrainingData->size();
+    vGradient.assign(m_nGenomSize, 0.0f);
+    if (nSize == 0) {
+        return 0.0f;
+    }
+    m_vOrder.resize(nSize);
+    for (int i = 0; i < nSize; ++i) {
+        m_vOrder[i] = i;
+    }
+    double nSumLoss = 0.0;
+    for (int nBegin = 0; nBegin < nSize; nBegin += m_nBatchSize) {
+        int nCount = std::min(m_nBatchSize, nSize - nBegin);
+        nSumLoss += this->forwardBackward(pWeights, m_vOrder.data() + nBegin, nCount, vGradient.data());
+    }
+    for (int i = 0; i < m_nGenomSize; ++i) {
+        vGradient[i] /= nSize;
+    }
+    return nSumLoss / nSize;
+}
+
+long long SimpleNeuralGradientTrainer::getNumberOfSteps() const {
+    return m_nSteps;
+}
+
+float SimpleNeuralGradientTrainer::forwardBackward(const float *pWeights, const int *pSamples, int nCount, float *pGradient) {
+    // adds the gradient of the sum of losses of samples, returns the sum of losses
+    m_vSignals.resize((size_t)m_nSignalsSize * nCount);
+    m_vSignalGradients.resize((size_t)m_nSignalsSize * nCount);
+    std::vector<SimpleNeuralTrainingItem>::iterator items = m_pTrainingData->begin();
+    int nLayers = m_vLayers.size();
+
+    // forward: the input layer multiplies every input by own weight
+    float *pInput = m_vSignals.data();
+    for (int b = 0; b < nCount; ++b) {
+        const std::vector<float> &vIn = items[pSamples[b]].getIn();
+        for (int i = 0; i < m_nInputSize; ++i) {
+            pInput[b * m_nInputSize + i] = vIn[i] * pWeights[i];
+        }
+    }
+    for (int l = 1; l < nLayers; ++l) {
+        int nPrev = m_vLayers[l - 1];
+        int nSize = m_vLayers[l];
+        const float *pW = pWeights + m_vWeightOffsets[l]; // [neuron][prev]
+        m_vTransposed.resize((size_t)nSize * nPrev);
+        for (int n = 0; n < nSize; ++n) {
+            for (int p = 0; p < nPrev; ++p) {
+                m_vTransposed[p * nSize + n] = pW[n * nPrev + p];
+            }
+        }
+        const float *pPrevSignals = m_vSignals.data() + (size_t)m_vSignalOffsets[l - 1] * nCount;
+        float *pSignals = m_vSignals.data() + (size_t)m_vSignalOffsets[l] * nCount;
+        for (int b = 0; b < nCount; ++b) {
+            float *pOut = pSignals + b * nSize;
+            std::fill(pOut, pOut + nSize, 0.0f);
+            for (int p = 0; p < nPrev; ++p) {
+                float nX = pPrevSignals[b * nPrev + p];
+                const float *pT = m_vTransposed.data() + p * nSize;
+                for (int n = 0; n < nSize; ++n) {
+                    pOut[n] += nX * pT[n];
+                }
+            }
+        }
+    }
+
+    // loss: 0.5 * |out - expected|^2, its gradient by outputs is (out - expected)
+    double nLoss = 0.0;
+    const float *pOutput = m_vSignals.data() + (size_t)m_vSignalOffsets[nLayers - 1] * nCount;
+    float *pOutputGradient = m_vSignalGradients.data() + (size_t)m_vSignalOffsets[nLayers - 1] * nCount;
+    for (int b = 0; b < nCount; ++b) {
+        const std::vector<float> &vOut = items[pSamples[b]].getOut();
+        for (int k = 0; k < m_nOutputSize; ++k) {
+            float nDiff = pOutput[b * m_nOutputSize + k] - vOut[k];
+            pOutputGradient[b * m_nOutputSize + k] = nDiff;
+            nLoss += 0.5 * nDiff * nDiff;
+        }
+    }
+
+    // backward
+    for (int l = nLayers - 1; l >= 1; --l) {
+        int nPrev = m_vLayers[l - 1];
+        int nSize = m_vLayers[l];
+        const float *pW = pWeights + m_vWeightOffsets[l];
+        float *pDW = pGradient + m_vWeightOffsets[l];
+        const float *pPrevSignals = m_vSignals.data() + (size_t)m_vSignalOffsets[l - 1] * nCount;
+        const float *pG = m_vSignalGradients.data() + (size_t)m_vSignalOffsets[l] * nCount;
+        float *pPrevG = m_vSignalGradients.data() + (size_t)m_vSignalOffsets[l - 1] * nCount;
+        for (int b = 0; b < nCount; ++b) {
+            const float *pA = pPrevSignals + b * nPrev;
+            const float *pGb = pG + b * nSize;
+            float *pPrevGb = pPrevG + b * nPrev;
+            std::fill(pPrevGb, pPrevGb + nPrev, 0.0f);
+            for (int n = 0; n < nSize; ++n) {
+                float nGn = pGb[n];
+                float *pDWn = pDW + n * nPrev;
+                const float *pWn = pW + n * nPrev;
+                for (int p = 0; p < nPrev; ++p) {
+                    pDWn[p] += nGn * pA[p];
+                    pPrevGb[p] += nGn * pWn[p];
+                }
+            }
+        }
+    }
+    const float *pInputGradient = m_vSignalGradients.data();
+    for (int b = 0; b < nCount; ++b) {
+        const std::vector<float> &vIn = items[pSamples[b]].getIn();
+        for (int i = 0; i < m_nInputSize; ++i) {
+            pGradient[i] += pInputGradient[b * m_nInputSize + i] * vIn[i];
+        }
+    }
+    return nLoss;
+}
+
+void SimpleNeuralGradientTrainer::applyGradient(float *pWeights) {
+    ++m_nSteps;
+    const float *pG = m_vGradient.data();
+    if (m_nOptimizer == SimpleNeuralOptimizer::SGD) {
+        for (int i = 0; i < m_nGenomSize; ++i) {
+            pWeights[i] -= m_nLearningRate * pG[i];
+        }
+    } else if (m_nOptimizer == SimpleNeuralOptimizer::Momentum) {
+        float *pV = m_vVelocity.data();
+        for (int i = 0; i < m_nGenomSize; ++i) {
+            pV[i] = m_nMomentum * pV[i] + pG[i];
+            pWeights[i] -= m_nLearningRate * pV[i];
+        }
+    } else {
+        float *pM = m_vVelocity.data();
+        float *pV = m_vSecondMoment.data();
+        // bias correction of the moments
+        float nStep1 = m_nLearningRate / (1.0f - std::pow(m_nBeta1, float(m_nSteps)));
+        float nCorrection2 = 1.0f / (1.0f - std::pow(m_nBeta2, float(m_nSteps)));
+        for (int i = 0; i < m_nGenomSize; ++i) {
+            pM[i] = m_nBeta1 * pM[i] + (1.0f - m_nBeta1) * pG[i];
+            pV[i] = m_nBeta2 * pV[i] + (1.0f - m_nBeta2) * pG[i] * pG[i];
+            pWeights[i] -= nStep1 * pM[i] / (std::sqrt(pV[i] * nCorrection2) + m_nEpsilon);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_GRADIENT_TRAINER_H__
+#define __SIMPLE_NEURAL_GRADIENT_TRAINER_H__
+
+#include <vector>
+#include <stdint.h>
+
+class SimpleNeuralNetwork;
+class SimpleNeuralTrainingItemList;
+
+enum class SimpleNeuralOptimizer {
+    SGD,
+    Momentum,
+    Adam
+};
+
+// Trains weights by the exact gradient of the mean squared error
+// (0.5 * |out - expected|^2 averaged over samples), weights in the same layout
+// as SimpleNeuralNetwork uses, so the result is a usual genom.
+// A mini-batch goes through every layer at once: forward and backward passes
+// are small matrix multiplications (samples x neurons).
+class SimpleNeuralGradientTrainer {
+    public:
+        SimpleNeuralGradientTrainer(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData);
+
+        void setOptimizer(SimpleNeuralOptimizer nOptimizer); // Adam by default
+        void setLearningRate(float nLearningRate); // 0.001 by default
+        void setMomentum(float nMomentum); // for Momentum (0.9 by default)
+        void setAdam(float nBeta1, float nBeta2, float nEpsilon); // 0.9, 0.999, 1e-8 by default
+        void setBatchSize(int nBatchSize); // 32 by default
+        void setRandomSeed(uint64_t nSeed); // for the order of samples
+
+        // one pass over the shuffled training data, returns the mean loss of the mini-batches
+        float trainEpoch(float *pWeights);
+        // loss and its gradient on the whole training data
+        float calculateGradient(const float *pWeights, std::vector<float> &vGradient);
+        long long getNumberOfSteps() const;
+
+    private:
+        float forwardBackward(const float *pWeights, const int *pSamples, int nCount, float *pGradient);
+        void applyGradient(float *pWeights);
+
+        std::vector<int> m_vLayers;
+        std::vector<int> m_vSignalOffsets; // of the first neuron of every layer
+        std::vector<int> m_vWeightOffsets; // of the first weight of every layer
+        int m_nGenomSize;
+        int m_nInputSize;
+        int m_nOutputSize;
+        int m_nSignalsSize;
+        SimpleNeuralTrainingItemList *m_pTrainingData;
+
+        SimpleNeuralOptimizer m_nOptimizer;
+        float m_nLearningRate;
+        float m_nMomentum;
+        float m_nBeta1;
+        float m_nBeta2;
+        float m_nEpsilon;
+        int m_nBatchSize;
+        uint64_t m_nRandomSeed;
+        long long m_nEpoch;
+        long long m_nSteps;
+
+        std::vector<int> m_vOrder;
+        std::vector<float> m_vGradient;
+        std::vector<float> m_vVelocity; // momentum or the first moment of Adam
+        std::vector<float> m_vSecondMoment;
+
+        // scratch of the batch: signals of all layers [layer][sample][neuron], their gradients
+        // and the transposed weights of a layer
+        std::vector<float> m_vSignals;
+        std::vector<float> m_vSignalGradients;
+        std::vector<float> m_vTransposed;
+};
+
+#endif // __SIMPLE_NEURAL_GRADIENT_TRAINER_H__
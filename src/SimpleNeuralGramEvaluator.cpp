@@ -0,0 +1,149 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralGramEvaluator.h"
+#include "SimpleNeuralLeastSquares.h"
+#include "SimpleNeuralNetwork.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralGramEvaluator
+
+SimpleNeuralGramEvaluator::SimpleNeuralGramEvaluator(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData) {
+    if (pNet->getLoss() != SimpleNeuralLoss::MeanSquared) {
+        throw std::runtime_error("SimpleNeuralGramEvaluator: only the mean squared loss is supported");
+    }
+    m_vLayers = pNet->getLayers();
+    m_nInputSize = m_vLayers.front();
+    m_nOutputSize = m_vLayers.back();
+    m_nGenomSize = pNet->getGenomSize();
+
+    SimpleNeuralLeastSquares statistics(pNet);
+    statistics.accumulate(pTrainingData);
+    m_nSamples = statistics.getNumberOfSamples();
+    const std::vector<double> &vXX = statistics.getXX();
+    const std::vector<double> &vXY = statistics.getXY();
+    m_vXX.resize(m_nInputSize * m_nInputSize);
+    for (int i = 0; i < m_nInputSize; ++i) {
+        for (int j = i; j < m_nInputSize; ++j) {
+            m_vXX[i * m_nInputSize + j] = vXX[i * m_nInputSize + j];
+            m_vXX[j * m_nInputSize + i] = vXX[i * m_nInputSize + j];
+        }
+    }
+    // transposed, so the sum of every output is the dot product of contiguous rows
+    m_vXY.resize(m_nOutputSize * m_nInputSize);
+    for (int i = 0; i < m_nInputSize; ++i) {
+        for (int k = 0; k < m_nOutputSize; ++k) {
+            m_vXY[k * m_nInputSize + i] = vXY[i * m_nOutputSize + k];
+        }
+    }
+    m_vYY = statistics.getYY();
+    this->setNumberOfWorkers(1);
+}
+
+void SimpleNeuralGramEvaluator::setNumberOfWorkers(int nWorkers) {
+    int nMaxLayerSize = *std::max_element(m_vLayers.begin(), m_vLayers.end());
+    m_vScratch.resize(nWorkers);
+    for (int i = 0; i < nWorkers; ++i) {
+        m_vScratch[i].vMatrix.resize(m_nOutputSize * nMaxLayerSize);
+        m_vScratch[i].vNext.resize(m_nOutputSize * nMaxLayerSize);
+    }
+}
+
+long long SimpleNeuralGramEvaluator::getNumberOfSamples() const {
+    return m_nSamples;
+}
+
+void SimpleNeuralGramEvaluator::collapse(const float *pWeights, std::vector<double> &vMatrix) const {
+    Scratch scratch;
+    int nMaxLayerSize = *std::max_element(m_vLayers.begin(), m_vLayers.end());
+    scratch.vMatrix.resize(m_nOutputSize * nMaxLayerSize);
+    scratch.vNext.resize(m_nOutputSize * nMaxLayerSize);
+    this->collapse(pWeights, scratch);
+    vMatrix.assign(scratch.vMatrix.begin(), scratch.vMatrix.begin() + m_nOutputSize * m_nInputSize);
+}
+
+void SimpleNeuralGramEvaluator::collapse(const float *pWeights, Scratch &scratch) const {
+    // from the last layer to the first: R = W_last, R = R * W_l, ..., M = R * diag(input weights)
+    int nLayers = m_vLayers.size();
+    const float *pLayerWeights = pWeights + m_nGenomSize - m_vLayers[nLayers - 1] * m_vLayers[nLayers - 2];
+    int nColumns = m_vLayers[nLayers - 2];
+    double *pR = scratch.vMatrix.data(); // [out][nColumns]
+    double *pNext = scratch.vNext.data();
+    for (int n = 0; n < m_nOutputSize * nColumns; ++n) {
+        pR[n] = pLayerWeights[n];
+    }
+    for (int nL = nLayers - 2; nL >= 1; --nL) {
+        const int nPrevLayerSize = m_vLayers[nL - 1];
+        pLayerWeights -= m_vLayers[nL] * nPrevLayerSize;
+        std::fill(pNext, pNext + m_nOutputSize * nPrevLayerSize, 0.0);
+        for (int k = 0; k < m_nOutputSize; ++k) {
+            double *pNextRow = pNext + k * nPrevLayerSize;
+            for (int nN = 0; nN < nColumns; ++nN) {
+                const double r = pR[k * nColumns + nN];
+                const float *pW = pLayerWeights + nN * nPrevLayerSize;
+                for (int nP = 0; nP < nPrevLayerSize; ++nP) {
+                    pNextRow[nP] += r * pW[nP];
+                }
+            }
+        }
+        std::swap(pR, pNext);
+        nColumns = nPrevLayerSize;
+    }
+    for (int k = 0; k < m_nOutputSize; ++k) {
+        for (int i = 0; i < m_nInputSize; ++i) {
+            pR[k * m_nInputSize + i] *= pWeights[i];
+        }
+    }
+    if (pR != scratch.vMatrix.data()) {
+        std::copy(pR, pR + m_nOutputSize * m_nInputSize, scratch.vMatrix.data());
+    }
+}
+
+void SimpleNeuralGramEvaluator::calculateRating(SimpleNeuralGenom &genom, int nWorker) {
+    Scratch &scratch = m_vScratch[nWorker];
+    this->collapse(genom.getWeights(), scratch);
+    double nSquaredErrors = 0.0;
+    for (int k = 0; k < m_nOutputSize; ++k) {
+        const double *pM = scratch.vMatrix.data() + k * m_nInputSize;
+        const double *pXY = m_vXY.data() + k * m_nInputSize;
+        double nQuadratic = 0.0;
+        double nLinear = 0.0;
+        for (int i = 0; i < m_nInputSize; ++i) {
+            const double *pXX = m_vXX.data() + i * m_nInputSize;
+            double nSum = 0.0;
+            for (int j = 0; j < m_nInputSize; ++j) {
+                nSum += pXX[j] * pM[j];
+            }
+            nQuadratic += pM[i] * nSum;
+            nLinear += pM[i] * pXY[i];
+        }
+        nSquaredErrors += nQuadratic - 2.0 * nLinear + m_vYY[k];
+    }
+    // the sum can be a little negative by the rounding for the exact solution
+    nSquaredErrors = std::max(nSquaredErrors, 0.0);
+    genom.setRating(m_nSamples == 0 ? 0.0f : float(nSquaredErrors / (double(m_nSamples) * m_nOutputSize)));
+}
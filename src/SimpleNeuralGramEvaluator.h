@@ -0,0 +1,72 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_GRAM_EVALUATOR_H__
+#define __SIMPLE_NEURAL_GRAM_EVALUATOR_H__
+
+#include <vector>
+
+class SimpleNeuralNetwork;
+class SimpleNeuralTrainingItemList;
+class SimpleNeuralGenom;
+
+// Rates genoms by the mean squared loss without a pass over the training data.
+// The network has no activation, so it's a linear map out = M * in, where M is the product
+// of the layers (the collapsed matrix), and the sum of squared errors over all samples is
+// sum_k (m_k^T X^T X m_k - 2 m_k^T (X^T Y)_k + (Y^T Y)_kk).
+// X^T X, X^T Y and Y^T Y are accumulated once (see SimpleNeuralLeastSquares), then a genom costs
+// out * (number of weights) to collapse and out * in * in for the sum: it does not depend on
+// the number of samples. The rating is the one of SimpleNeuralLoss::MeanSquared up to the rounding
+// (sums are in double here and in float in SimpleNeuralNetwork::calcLoss).
+// Only the mean squared loss is supported.
+class SimpleNeuralGramEvaluator {
+    public:
+        SimpleNeuralGramEvaluator(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData);
+
+        void setNumberOfWorkers(int nWorkers);
+        long long getNumberOfSamples() const;
+        // the collapsed matrix [out][in] of the genom
+        void collapse(const float *pWeights, std::vector<double> &vMatrix) const;
+        // nWorker selects the scratch buffers (0 <= nWorker < number of workers)
+        void calculateRating(SimpleNeuralGenom &genom, int nWorker = 0);
+
+    private:
+        struct Scratch {
+            std::vector<double> vMatrix;
+            std::vector<double> vNext;
+        };
+        void collapse(const float *pWeights, Scratch &scratch) const;
+
+        std::vector<int> m_vLayers;
+        int m_nInputSize;
+        int m_nOutputSize;
+        int m_nGenomSize;
+        long long m_nSamples;
+        std::vector<double> m_vXX; // [in][in], both triangles
+        std::vector<double> m_vXY; // [out][in]
+        std::vector<double> m_vYY; // [out]
+        std::vector<Scratch> m_vScratch; // one per worker
+};
+
+#endif // __SIMPLE_NEURAL_GRAM_EVALUATOR_H__
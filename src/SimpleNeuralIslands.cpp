@@ -0,0 +1,216 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralIslands.h"
+#include "SimpleNeuralThreadPool.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralIslands
+
+SimpleNeuralIslands::SimpleNeuralIslands(int nIslands, int nBetter, int nMutate, int nMix) {
+    if (nIslands < 1) {
+        throw std::runtime_error("SimpleNeuralIslands: expected at least one island");
+    }
+    for (int i = 0; i < nIslands; ++i) {
+        m_vIslands.emplace_back(new SimpleNeuralGenomList(nBetter, nMutate, nMix));
+    }
+    m_nRandomSeed = std::rand();
+    for (int i = 0; i < nIslands; ++i) {
+        m_vIslands[i]->setRandomSeed(SimpleNeuralRandom(m_nRandomSeed, i).next());
+    }
+    m_nTopology = SimpleNeuralMigration::Ring;
+    m_nMigrationInterval = 10;
+    m_nMigrationSize = 1;
+    m_nGeneration = 0;
+    m_nMigrants = 0;
+    m_pIslandNetsSource = nullptr;
+    this->setNumberOfThreads(0);
+}
+
+SimpleNeuralIslands::~SimpleNeuralIslands() {
+    // defined here, where SimpleNeuralThreadPool is a complete type
+}
+
+void SimpleNeuralIslands::setNumberOfThreads(int nThreads) {
+    if (nThreads < 1) {
+        nThreads = SimpleNeuralThreadPool::getDefaultNumberOfThreads();
+    }
+    // more threads than islands are useless
+    nThreads = std::min<int>(nThreads, m_vIslands.size());
+    if (nThreads == 1) {
+        m_pThreadPool.reset();
+    } else {
+        m_pThreadPool.reset(new SimpleNeuralThreadPool(nThreads));
+    }
+}
+
+int SimpleNeuralIslands::getNumberOfThreads() const {
+    return m_pThreadPool ? m_pThreadPool->getNumberOfThreads() : 1;
+}
+
+void SimpleNeuralIslands::setRandomSeed(uint64_t nSeed) {
+    m_nRandomSeed = nSeed;
+    for (int i = 0; i < m_vIslands.size(); ++i) {
+        m_vIslands[i]->setRandomSeed(SimpleNeuralRandom(m_nRandomSeed, i).next());
+    }
+}
+
+void SimpleNeuralIslands::setMigration(SimpleNeuralMigration nTopology, int nInterval, int nSize) {
+    if (nInterval < 1 || nSize < 0) {
+        throw std::runtime_error("SimpleNeuralIslands: wrong interval or size of migration");
+    }
+    m_nTopology = nTopology;
+    m_nMigrationInterval = nInterval;
+    m_nMigrationSize = nSize;
+}
+
+int SimpleNeuralIslands::getNumberOfIslands() const {
+    return m_vIslands.size();
+}
+
+SimpleNeuralGenomList &SimpleNeuralIslands::island(int nIsland) {
+    return *m_vIslands[nIsland];
+}
+
+long long SimpleNeuralIslands::getGeneration() const {
+    return m_nGeneration;
+}
+
+long long SimpleNeuralIslands::getNumberOfMigrants() const {
+    return m_nMigrants;
+}
+
+void SimpleNeuralIslands::fillRandom(SimpleNeuralNetwork *pNet) {
+    for (int i = 0; i < m_vIslands.size(); ++i) {
+        m_vIslands[i]->fillRandom(pNet);
+    }
+}
+
+void SimpleNeuralIslands::calculateRatingForAll(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData) {
+    this->runOnIslands(pNet, [&](int nIsland, SimpleNeuralNetwork *pIslandNet) {
+        m_vIslands[nIsland]->calculateRatingForAll(pIslandNet, pTrainingData);
+    });
+}
+
+void SimpleNeuralIslands::evolve(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, int nGenerations) {
+    while (nGenerations > 0) {
+        // islands evolve independently until the next migration
+        int nToMigration = m_nMigrationInterval - int(m_nGeneration % m_nMigrationInterval);
+        int nSteps = std::min(nGenerations, nToMigration);
+        this->runOnIslands(pNet, [&](int nIsland, SimpleNeuralNetwork *pIslandNet) {
+            SimpleNeuralGenomList &genoms = *m_vIslands[nIsland];
+            for (int n = 0; n < nSteps; ++n) {
+                genoms.sort();
+                genoms.mutateAndMix(pIslandNet);
+                genoms.calculateRatingForMutatedAndMixed(pIslandNet, pTrainingData);
+            }
+        });
+        m_nGeneration += nSteps;
+        nGenerations -= nSteps;
+        if (m_nGeneration % m_nMigrationInterval == 0) {
+            this->migrate();
+        }
+    }
+}
+
+float SimpleNeuralIslands::getBetterRating() {
+    return this->getBetterGenom().getRating();
+}
+
+const SimpleNeuralGenom &SimpleNeuralIslands::getBetterGenom() {
+    int nBetter = 0;
+    for (int i = 1; i < m_vIslands.size(); ++i) {
+        if (m_vIslands[i]->getBetterGenom().isBetterThan(m_vIslands[nBetter]->getBetterGenom())) {
+            nBetter = i;
+        }
+    }
+    return m_vIslands[nBetter]->getBetterGenom();
+}
+
+void SimpleNeuralIslands::runOnIslands(
+    SimpleNeuralNetwork *pNet,
+    const std::function<void(int nIsland, SimpleNeuralNetwork *pIslandNet)> &func
+) {
+    // network keeps statistics of calc, so every island needs own copy
+    if (m_pIslandNetsSource != pNet) {
+        m_vIslandNets.clear();
+        m_vIslandNets.reserve(m_vIslands.size());
+        for (int i = 0; i < m_vIslands.size(); ++i) {
+            m_vIslandNets.emplace_back(*pNet);
+        }
+        m_pIslandNetsSource = pNet;
+    }
+    // the loss can be changed after the copy
+    for (int i = 0; i < m_vIslandNets.size(); ++i) {
+        m_vIslandNets[i].setLoss(pNet->getLoss());
+    }
+    if (m_pThreadPool) {
+        m_pThreadPool->parallelFor(0, m_vIslands.size(), [&](int /* nWorker */, int nIsland) {
+            func(nIsland, &m_vIslandNets[nIsland]);
+        });
+    } else {
+        for (int i = 0; i < m_vIslands.size(); ++i) {
+            func(i, &m_vIslandNets[i]);
+        }
+    }
+    for (int i = 0; i < m_vIslandNets.size(); ++i) {
+        pNet->mergeCalcStatistics(m_vIslandNets[i]);
+    }
+}
+
+void SimpleNeuralIslands::migrate() {
+    int nIslands = m_vIslands.size();
+    if (nIslands < 2 || m_nMigrationSize == 0) {
+        return;
+    }
+    // copies of migrants first: an island sends and receives at the same time
+    std::vector<std::vector<float>> vMigrants(nIslands * m_nMigrationSize);
+    std::vector<float> vRatings(nIslands * m_nMigrationSize);
+    for (int i = 0; i < nIslands; ++i) {
+        SimpleNeuralGenomList &genoms = *m_vIslands[i];
+        genoms.sort();
+        int nSize = std::min<int>(m_nMigrationSize, genoms.list().size());
+        for (int n = 0; n < nSize; ++n) {
+            vMigrants[i * m_nMigrationSize + n] = genoms.list()[n].getGenom();
+            vRatings[i * m_nMigrationSize + n] = genoms.list()[n].getRating();
+        }
+    }
+    SimpleNeuralRandom random(m_nRandomSeed, (uint64_t(1) << 62) | uint64_t(m_nGeneration));
+    for (int i = 0; i < nIslands; ++i) {
+        int nTarget = (i + 1) % nIslands;
+        if (m_nTopology == SimpleNeuralMigration::Random) {
+            nTarget = (i + 1 + random.nextInt(nIslands - 1)) % nIslands;
+        }
+        for (int n = 0; n < m_nMigrationSize; ++n) {
+            const std::vector<float> &vWeights = vMigrants[i * m_nMigrationSize + n];
+            if (!vWeights.empty() && m_vIslands[nTarget]->replaceWorstGenom(vWeights.data(), vRatings[i * m_nMigrationSize + n])) {
+                ++m_nMigrants;
+            }
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_ISLANDS_H__
+#define __SIMPLE_NEURAL_ISLANDS_H__
+
+#include "SimpleNeuralNetwork.h"
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <stdint.h>
+
+class SimpleNeuralThreadPool;
+
+enum class SimpleNeuralMigration {
+    Ring,   // island i sends its better genoms to island i + 1
+    Random  // every island sends to a random other island
+};
+
+// Island model: several independent populations, each evolves on own thread
+// with own copy of network. Threads are synchronized only for the migration:
+// every nInterval generations the nSize better genoms of every island
+// replace the worst genoms of another island.
+class SimpleNeuralIslands {
+    public:
+        SimpleNeuralIslands(int nIslands, int nBetter, int nMutate, int nMix);
+        ~SimpleNeuralIslands();
+        void setNumberOfThreads(int nThreads); // 0 - all hardware threads (default), 1 - serial
+        int getNumberOfThreads() const;
+        void setRandomSeed(uint64_t nSeed); // island i gets own seed from (nSeed, i)
+        void setMigration(SimpleNeuralMigration nTopology, int nInterval, int nSize);
+        int getNumberOfIslands() const;
+        SimpleNeuralGenomList &island(int nIsland); // for settings of the island (crossover, racing, etc.)
+        long long getGeneration() const;
+        long long getNumberOfMigrants() const; // accepted by islands
+
+        void fillRandom(SimpleNeuralNetwork *pNet);
+        void calculateRatingForAll(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData);
+        // sort, mutateAndMix and rating of children on every island, migration between them
+        void evolve(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, int nGenerations);
+
+        float getBetterRating();
+        const SimpleNeuralGenom &getBetterGenom();
+
+    private:
+        void runOnIslands(SimpleNeuralNetwork *pNet, const std::function<void(int nIsland, SimpleNeuralNetwork *pIslandNet)> &func);
+        void migrate();
+
+        std::vector<std::unique_ptr<SimpleNeuralGenomList>> m_vIslands;
+        std::vector<SimpleNeuralNetwork> m_vIslandNets;
+        SimpleNeuralNetwork *m_pIslandNetsSource;
+        std::unique_ptr<SimpleNeuralThreadPool> m_pThreadPool;
+        uint64_t m_nRandomSeed;
+        SimpleNeuralMigration m_nTopology;
+        int m_nMigrationInterval;
+        int m_nMigrationSize;
+        long long m_nGeneration;
+        long long m_nMigrants;
+};
+
+#endif // __SIMPLE_NEURAL_ISLANDS_H__
@@ -0,0 +1,226 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralLeastSquares.h"
+#include "SimpleNeuralNetwork.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <string>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralLeastSquares
+
+SimpleNeuralLeastSquares::SimpleNeuralLeastSquares(SimpleNeuralNetwork *pNet) {
+    m_vLayers = pNet->getLayers();
+    m_nGenomSize = pNet->getGenomSize();
+    m_nInputSize = m_vLayers.front();
+    m_nOutputSize = m_vLayers.back();
+    m_nRidge = 1e-10;
+    this->reset();
+}
+
+void SimpleNeuralLeastSquares::setRidge(double nRidge) {
+    m_nRidge = nRidge;
+}
+
+void SimpleNeuralLeastSquares::reset() {
+    m_nSamples = 0;
+    m_vXX.assign(m_nInputSize * m_nInputSize, 0.0);
+    m_vXY.assign(m_nInputSize * m_nOutputSize, 0.0);
+    m_vYY.assign(m_nOutputSize, 0.0);
+    m_vMatrix.clear();
+}
+
+void SimpleNeuralLeastSquares::accumulate(SimpleNeuralTrainingItemList *pTrainingData) {
+    if (pTrainingData->getNumberOfIn() != m_nInputSize || pTrainingData->getNumberOfOut() != m_nOutputSize) {
+        throw std::runtime_error("SimpleNeuralLeastSquares: training data does not match the network");
+    }
+    // a block of samples is transposed, so every sum is the dot product of two contiguous rows
+    m_vBlockX.resize(m_nInputSize * BLOCK_SAMPLES);
+    m_vBlockY.resize(m_nOutputSize * BLOCK_SAMPLES);
+    std::vector<SimpleNeuralTrainingItem>::iterator it = pTrainingData->begin();
+    while (it != pTrainingData->end()) {
+        int nCount = 0;
+        for (; nCount < BLOCK_SAMPLES && it != pTrainingData->end(); ++nCount, ++it) {
+            const std::vector<float> &vIn = it->getIn();
+            const std::vector<float> &vOut = it->getOut();
+            for (int i = 0; i < m_nInputSize; ++i) {
+                m_vBlockX[i * BLOCK_SAMPLES + nCount] = vIn[i];
+            }
+            for (int k = 0; k < m_nOutputSize; ++k) {
+                m_vBlockY[k * BLOCK_SAMPLES + nCount] = vOut[k];
+            }
+        }
+        for (int i = 0; i < m_nInputSize; ++i) {
+            const double *pXi = m_vBlockX.data() + i * BLOCK_SAMPLES;
+            for (int j = i; j < m_nInputSize; ++j) {
+                const double *pXj = m_vBlockX.data() + j * BLOCK_SAMPLES;
+                double nSum = 0.0;
+                for (int b = 0; b < nCount; ++b) {
+                    nSum += pXi[b] * pXj[b];
+                }
+                m_vXX[i * m_nInputSize + j] += nSum;
+            }
+            for (int k = 0; k < m_nOutputSize; ++k) {
+                const double *pYk = m_vBlockY.data() + k * BLOCK_SAMPLES;
+                double nSum = 0.0;
+                for (int b = 0; b < nCount; ++b) {
+                    nSum += pXi[b] * pYk[b];
+                }
+                m_vXY[i * m_nOutputSize + k] += nSum;
+            }
+        }
+        for (int k = 0; k < m_nOutputSize; ++k) {
+            const double *pYk = m_vBlockY.data() + k * BLOCK_SAMPLES;
+            double nSum = 0.0;
+            for (int b = 0; b < nCount; ++b) {
+                nSum += pYk[b] * pYk[b];
+            }
+            m_vYY[k] += nSum;
+        }
+        m_nSamples += nCount;
+    }
+}
+
+long long SimpleNeuralLeastSquares::getNumberOfSamples() const {
+    return m_nSamples;
+}
+
+const std::vector<double> &SimpleNeuralLeastSquares::getXX() const {
+    return m_vXX;
+}
+
+const std::vector<double> &SimpleNeuralLeastSquares::getXY() const {
+    return m_vXY;
+}
+
+const std::vector<double> &SimpleNeuralLeastSquares::getYY() const {
+    return m_vYY;
+}
+
+void SimpleNeuralLeastSquares::solve() {
+    int n = m_nInputSize;
+    // A = X^T X + ridge, lower triangle L of A = L * L^T in place
+    std::vector<double> vL(n * n, 0.0);
+    double nTrace = 0.0;
+    for (int i = 0; i < n; ++i) {
+        nTrace += m_vXX[i * n + i];
+    }
+    double nRidge = m_nRidge * (nTrace > 0.0 ? nTrace / n : 1.0);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j <= i; ++j) {
+            vL[i * n + j] = m_vXX[j * n + i] + (i == j ? nRidge : 0.0);
+        }
+    }
+    for (int j = 0; j < n; ++j) {
+        double nDiagonal = vL[j * n + j];
+        for (int k = 0; k < j; ++k) {
+            nDiagonal -= vL[j * n + k] * vL[j * n + k];
+        }
+        if (!(nDiagonal > 0.0)) {
+            throw std::runtime_error("SimpleNeuralLeastSquares: inputs are linearly dependent, increase the ridge");
+        }
+        nDiagonal = std::sqrt(nDiagonal);
+        vL[j * n + j] = nDiagonal;
+        for (int i = j + 1; i < n; ++i) {
+            double nSum = vL[i * n + j];
+            for (int k = 0; k < j; ++k) {
+                nSum -= vL[i * n + k] * vL[j * n + k];
+            }
+            vL[i * n + j] = nSum / nDiagonal;
+        }
+    }
+    // L * L^T * m = X^T y for every output
+    m_vMatrix.assign(m_nOutputSize * n, 0.0);
+    std::vector<double> vZ(n);
+    for (int k = 0; k < m_nOutputSize; ++k) {
+        for (int i = 0; i < n; ++i) {
+            double nSum = m_vXY[i * m_nOutputSize + k];
+            for (int j = 0; j < i; ++j) {
+                nSum -= vL[i * n + j] * vZ[j];
+            }
+            vZ[i] = nSum / vL[i * n + i];
+        }
+        double *pM = m_vMatrix.data() + k * n;
+        for (int i = n - 1; i >= 0; --i) {
+            double nSum = vZ[i];
+            for (int j = i + 1; j < n; ++j) {
+                nSum -= vL[j * n + i] * pM[j];
+            }
+            pM[i] = nSum / vL[i * n + i];
+        }
+    }
+}
+
+const std::vector<double> &SimpleNeuralLeastSquares::getMatrix() const {
+    return m_vMatrix;
+}
+
+std::vector<float> SimpleNeuralLeastSquares::getGenom() const {
+    if (m_vMatrix.empty()) {
+        throw std::runtime_error("SimpleNeuralLeastSquares: solve() was not called");
+    }
+    int nLayers = m_vLayers.size();
+    int nNarrowest = m_nInputSize;
+    for (int l = 1; l < nLayers - 1; ++l) {
+        nNarrowest = std::min(nNarrowest, m_vLayers[l]);
+    }
+    // the middle layers pass the inputs (M in the last layer) or the outputs (M in the first layer)
+    int nMapLayer;
+    if (nLayers == 2 || nNarrowest >= m_nInputSize) {
+        nMapLayer = nLayers - 1;
+    } else if (nNarrowest >= m_nOutputSize) {
+        nMapLayer = 1;
+    } else {
+        throw std::runtime_error("SimpleNeuralLeastSquares: the middle layer of " + std::to_string(nNarrowest)
+            + " neurons is narrower than inputs and outputs");
+    }
+
+    std::vector<float> vGenom(m_nGenomSize, 0.0f);
+    for (int i = 0; i < m_nInputSize; ++i) {
+        vGenom[i] = 1.0f;
+    }
+    int nOffset = m_nInputSize;
+    for (int l = 1; l < nLayers; ++l) {
+        int nPrev = m_vLayers[l - 1];
+        int nSize = m_vLayers[l];
+        float *pW = vGenom.data() + nOffset; // [neuron][prev]
+        if (l == nMapLayer) {
+            for (int k = 0; k < m_nOutputSize; ++k) {
+                for (int i = 0; i < m_nInputSize; ++i) {
+                    pW[k * nPrev + i] = m_vMatrix[k * m_nInputSize + i];
+                }
+            }
+        } else {
+            int nPass = l < nMapLayer ? m_nInputSize : m_nOutputSize;
+            for (int i = 0; i < nPass; ++i) {
+                pW[i * nPrev + i] = 1.0f;
+            }
+        }
+        nOffset += nSize * nPrev;
+    }
+    return vGenom;
+}
@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_LEAST_SQUARES_H__
+#define __SIMPLE_NEURAL_LEAST_SQUARES_H__
+
+#include <vector>
+
+class SimpleNeuralNetwork;
+class SimpleNeuralTrainingItemList;
+
+// The network has no activation, so it's a linear map out = M * in, and the best M
+// is the least squares solution: (X^T X) M^T = X^T Y.
+// X^T X and X^T Y are accumulated over blocks of samples, the system is solved by Cholesky.
+// The map is written into the layers of the network: one layer does M,
+// the others pass the signals through (the narrowest middle layer must be
+// not less than the number of inputs or outputs).
+// The genom can be used as is or as the start of the genetic algorithm
+// (SimpleNeuralNetwork::setGenom + fillRandom, the genom itself by SimpleNeuralGenomList::replaceWorstGenom).
+class SimpleNeuralLeastSquares {
+    public:
+        explicit SimpleNeuralLeastSquares(SimpleNeuralNetwork *pNet);
+
+        void setRidge(double nRidge); // added to the diagonal, relative to the mean of it (1e-10 by default)
+        void reset();
+        void accumulate(SimpleNeuralTrainingItemList *pTrainingData); // can be called for several lists
+        long long getNumberOfSamples() const;
+        // the accumulated statistics (see SimpleNeuralGramEvaluator)
+        const std::vector<double> &getXX() const; // [in][in], only the upper triangle
+        const std::vector<double> &getXY() const; // [in][out]
+        const std::vector<double> &getYY() const; // [out], the diagonal of Y^T Y
+        void solve();
+        const std::vector<double> &getMatrix() const; // [out][in]
+        std::vector<float> getGenom() const;
+
+        static constexpr int BLOCK_SAMPLES = 64;
+
+    private:
+        std::vector<int> m_vLayers;
+        int m_nGenomSize;
+        int m_nInputSize;
+        int m_nOutputSize;
+        double m_nRidge;
+        long long m_nSamples;
+        std::vector<double> m_vXX; // [in][in], only the upper triangle is accumulated
+        std::vector<double> m_vXY; // [in][out]
+        std::vector<double> m_vYY; // [out]
+        std::vector<double> m_vMatrix; // [out][in]
+        std::vector<double> m_vBlockX; // [in][BLOCK_SAMPLES]
+        std::vector<double> m_vBlockY; // [out][BLOCK_SAMPLES]
+};
+
+#endif // __SIMPLE_NEURAL_LEAST_SQUARES_H__
@@ -23,15 +23,28 @@ SOFTWARE.
 */
 
 #include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralThreadPool.h"
+#include "SimpleNeuralBatchEvaluator.h"
+#include "SimpleNeuralDeltaEvaluator.h"
+#include "SimpleNeuralGramEvaluator.h"
+#include "SimpleNeuralRatingCache.h"
+#include "SimpleNeuralRemote.h"
+#include "SimpleNeuralCheckpoint.h"
+#include "SimpleNeuralAnytimeTrainer.h"
 
 #include <cstdlib>
+#include <stdint.h>
+#include <stdexcept>
 #include <iostream>
 #include <ctime>
 #include <chrono>
 #include <algorithm>
 #include <math.h>
+#include <cmath>
 #include <fstream>
 #include <iomanip>
+#include <cstring>
+#include <limits>
 
 
 // ---------------------------------------------------------------------
@@ -42,6 +55,8 @@ SimpleNeuralNetwork::SimpleNeuralNetwork(std::vector<int> vLayers)
 {
     m_nCalcSumMs= 0;
     m_nCalcCounter = 0;
+    m_nLoss = SimpleNeuralLoss::Euclidean;
+    m_random.seed(std::rand()); // std::srand() still makes the runs reproducible
     m_nLayersSize = m_vLayers.size();
     m_nInputSize = m_vLayers[0];
     for (int i = 0; i < m_nInputSize; i++) {
@@ -54,7 +69,7 @@ SimpleNeuralNetwork::SimpleNeuralNetwork(std::vector<int> vLayers)
         for (int nN = 0; nN < nPrevLayerSize; nN++) {
             m_vBufferSignals.push_back(0.0f);
             for(int nP = 0; nP < nLayerSize; nP++) {
-                float nWeight = this->randomWeight();
+                float nWeight = this->randomWeight(m_random);
                 // float nWeight = 1.0f;
                 m_vWeights.push_back(nWeight);
             }
@@ -74,6 +89,10 @@ SimpleNeuralNetwork::SimpleNeuralNetwork(std::vector<int> vLayers)
 }
 
 const std::vector<float> &SimpleNeuralNetwork::calc(const std::vector<float> &vInput) {
+    return this->calc(m_vWeights.data(), vInput);
+}
+
+const std::vector<float> &SimpleNeuralNetwork::calc(const float *pWeights, const std::vector<float> &vInput) {
     auto start = std::chrono::steady_clock::now();
     int nOffset = 0;
     float nSum = 0;
@@ -83,7 +102,7 @@ const std::vector<float> &SimpleNeuralNetwork::calc(const std::vector<float> &vI
 
     int i = 0;
     while(i < m_nInputSize) {
-        m_vBufferSignals[i] = vInput[i] * m_vWeights[i];
+        m_vBufferSignals[i] = vInput[i] * pWeights[i];
         ++i;
     }
 
@@ -109,7 +128,7 @@ const std::vector<float> &SimpleNeuralNetwork::calc(const std::vector<float> &vI
             nP = 0;
             while (nP < nPrevLayerSize) {
                 nBufferSignalN = nSignalOffset + nP;
-                nSum += m_vBufferSignals[nBufferSignalN] * m_vWeights[nWeightOffset];
+                nSum += m_vBufferSignals[nBufferSignalN] * pWeights[nWeightOffset];
                 ++nWeightOffset;
                 ++nP;
             }
@@ -140,62 +159,241 @@ const std::vector<float> &SimpleNeuralNetwork::calc(const std::vector<float> &vI
     return m_vBufferOutput;
 }
 
+float SimpleNeuralNetwork::calcLoss(const float *pWeights, const float *pInput, const float *pExpected) {
+    float *pSignals = m_vBufferSignals.data();
+    for (int i = 0; i < m_nInputSize; ++i) {
+        pSignals[i] = pInput[i] * pWeights[i];
+    }
+    const float *pLayerWeights = pWeights + m_nInputSize;
+    float *pPrev = pSignals;
+    for (int nL = 1; nL < m_nLayersSize; ++nL) {
+        const int nPrevLayerSize = m_vLayers[nL - 1];
+        const int nLayerSize = m_vLayers[nL];
+        float *pOut = pPrev + nPrevLayerSize;
+        // eight neurons at once: independent chains of additions instead of one
+        int nN = 0;
+        for (; nN + 8 <= nLayerSize; nN += 8) {
+            const float *pW = pLayerWeights + nN * nPrevLayerSize;
+            float vSums[8] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+            for (int nP = 0; nP < nPrevLayerSize; ++nP) {
+                const float x = pPrev[nP];
+                for (int k = 0; k < 8; ++k) {
+                    vSums[k] += x * pW[k * nPrevLayerSize + nP];
+                }
+            }
+            for (int k = 0; k < 8; ++k) {
+                pOut[nN + k] = vSums[k];
+            }
+        }
+        for (; nN < nLayerSize; ++nN) {
+            const float *pW = pLayerWeights + nN * nPrevLayerSize;
+            float nSum = 0.0f;
+            for (int nP = 0; nP < nPrevLayerSize; ++nP) {
+                nSum += pPrev[nP] * pW[nP];
+            }
+            pOut[nN] = nSum;
+        }
+        pLayerWeights += nLayerSize * nPrevLayerSize;
+        pPrev = pOut;
+    }
+
+    // reduction over outputs in the order of the former code, so Euclidean ratings are not changed
+    float nLoss = 0.0f;
+    if (m_nLoss == SimpleNeuralLoss::Euclidean || m_nLoss == SimpleNeuralLoss::MeanSquared) {
+        for (int i = 0; i < m_nOutputSize; ++i) {
+            float d = pExpected[i] - pPrev[i];
+            nLoss += d * d;
+        }
+        return m_nLoss == SimpleNeuralLoss::Euclidean ? std::sqrt(nLoss) : nLoss / m_nOutputSize;
+    }
+    for (int i = 0; i < m_nOutputSize; ++i) {
+        float d = std::fabs(pExpected[i] - pPrev[i]);
+        nLoss = m_nLoss == SimpleNeuralLoss::MaxError ? std::max(nLoss, d) : nLoss + d;
+    }
+    return m_nLoss == SimpleNeuralLoss::MaxError ? nLoss : nLoss / m_nOutputSize;
+}
+
+const std::vector<int> &SimpleNeuralNetwork::getLayers() const {
+    return m_vLayers;
+}
+
 long long SimpleNeuralNetwork::getCalcAvarageTimeInNanoseconds() {
     // std::cout
     //     << "m_nCalcSumMs = " << m_nCalcSumMs << std::endl
     //     << "m_nCalcCounter = " << m_nCalcCounter << std::endl
     // ;
+    if (m_nCalcCounter == 0) {
+        return 0;
+    }
     return m_nCalcSumMs / m_nCalcCounter;
 }
 
+void SimpleNeuralNetwork::mergeCalcStatistics(SimpleNeuralNetwork &net) {
+    m_nCalcSumMs += net.m_nCalcSumMs;
+    m_nCalcCounter += net.m_nCalcCounter;
+    net.m_nCalcSumMs = 0;
+    net.m_nCalcCounter = 0;
+}
+
+void SimpleNeuralNetwork::addCalcStatistics(long long nNanoseconds, int nCalls) {
+    m_nCalcSumMs += nNanoseconds;
+    m_nCalcCounter += nCalls;
+}
+
+void SimpleNeuralNetwork::setLoss(SimpleNeuralLoss nLoss) {
+    m_nLoss = nLoss;
+}
+
+SimpleNeuralLoss SimpleNeuralNetwork::getLoss() const {
+    return m_nLoss;
+}
+
 const std::vector<float> &SimpleNeuralNetwork::getGenom() {
     return m_vWeights;
 }
 
+int SimpleNeuralNetwork::getGenomSize() const {
+    return m_vWeights.size();
+}
+
 void SimpleNeuralNetwork::setGenom(const std::vector<float> &vWeights) {
     m_vWeights = vWeights;
 }
 
+void SimpleNeuralNetwork::setRandomSeed(uint64_t nSeed) {
+    m_random.seed(nSeed);
+}
+
 void SimpleNeuralNetwork::mutateGenom() {
-    int nTypeOfMutation = std::rand() % 2;
-    if (nTypeOfMutation == 0) {
-        // light mutation
-        int nCountOfMutations = std::rand() % m_vWeights.size();
+    this->mutateGenom(m_vWeights.data(), m_random);
+}
+
+void SimpleNeuralNetwork::mutateGenom(float *pWeights) {
+    this->mutateGenom(pWeights, m_random);
+}
+
+void SimpleNeuralNetwork::mutateGenom(float *pWeights, SimpleNeuralRandom &random, float nSigma) const {
+    int nSize = m_vWeights.size();
+    int nTypeOfMutation = random.nextInt(2);
+    int nCountOfMutations = nSize;
+    if (nSize > 5) {
+        nCountOfMutations = random.nextInt(nSize);
         while (nCountOfMutations < 5) {
             // no mutation - it's not a option
-            nCountOfMutations = std::rand() % m_vWeights.size();
+            nCountOfMutations = random.nextInt(nSize);
         }
-        for (int i = 0; i < nCountOfMutations; i++) {
-            int n = std::rand() % m_vWeights.size();
-            float nSign = float((std::rand() % 2) - 1);
-            // change only of 1% of genom
-            m_vWeights[n] = m_vWeights[n] + nSign * m_vWeights[n] * 0.01f;
-        }
-    } else {
-        // hard mutation
-        int nCountOfMutations = std::rand() % m_vWeights.size();
-        while (nCountOfMutations < 5) {
-            // no mutation - it's not a option
-            nCountOfMutations = std::rand() % m_vWeights.size();
+    }
+
+    // Mutations are applied as a random mask in one pass over the genom:
+    // every weight is changed with probability nCountOfMutations / nSize.
+    // Randoms are generated by blocks, loops have no branches and are vectorized.
+    // For every weight: low 32 bits - mask, high 32 bits - sign or new value
+    const uint32_t nThreshold = uint32_t(std::min<uint64_t>(((uint64_t)nCountOfMutations << 32) / nSize, 0xFFFFFFFFULL));
+    constexpr int nBlock = 256;
+    uint64_t vRandom[nBlock];
+    float vGaussian[nBlock];
+    int nMutated = 0;
+    for (int nFirst = 0; nFirst < nSize; nFirst += nBlock) {
+        int nCount = std::min(nBlock, nSize - nFirst);
+        float *pBlock = pWeights + nFirst;
+        random.fill(vRandom, nCount);
+        if (nTypeOfMutation == 0 && nSigma > 0.0f) {
+            // light mutation with own step of genom
+            random.fillGaussian(vGaussian, nCount);
+            for (int i = 0; i < nCount; ++i) {
+                float nChange = uint32_t(vRandom[i]) < nThreshold ? nSigma * vGaussian[i] : 0.0f;
+                pBlock[i] = pBlock[i] + nChange * pBlock[i];
+            }
+        } else if (nTypeOfMutation == 0) {
+            // light mutation, change only of 1% of weight
+            for (int i = 0; i < nCount; ++i) {
+                float nChange = uint32_t(vRandom[i]) < nThreshold ? 0.01f : 0.0f;
+                float nSign = float(int((vRandom[i] >> 31) & 2) - 1);
+                pBlock[i] = pBlock[i] + nSign * nChange * pBlock[i];
+            }
+        } else {
+            // hard mutation, new random weight (as randomWeight)
+            for (int i = 0; i < nCount; ++i) {
+                float nWeight = float(int(((vRandom[i] >> 32) * 200) >> 32) - 100) / 100.0f;
+                pBlock[i] = uint32_t(vRandom[i]) < nThreshold ? nWeight : pBlock[i];
+            }
         }
-        for (int i = 0; i < nCountOfMutations; i++) {
-            int n = std::rand() % m_vWeights.size();
-            m_vWeights[n] = this->randomWeight();
+        for (int i = 0; i < nCount; ++i) {
+            nMutated += uint32_t(vRandom[i]) < nThreshold ? 1 : 0;
         }
     }
 
+    if (nMutated == 0) {
+        // no mutation - it's not a option
+        int n = random.nextInt(nSize);
+        pWeights[n] = this->randomWeight(random);
+    }
 }
 
 void SimpleNeuralNetwork::mixGenom(const std::vector<float> &vWeights) {
-    for (int i = 0; i < m_vWeights.size(); i++) {
-        if (std::rand() % 2 == 0) {
-            m_vWeights[i] = vWeights[i];
+    this->mixGenom(m_vWeights.data(), vWeights.data(), m_vWeights.data(), m_random);
+}
+
+void SimpleNeuralNetwork::mixGenom(const float *pWeights0, const float *pWeights1, float *pOut) {
+    this->mixGenom(pWeights0, pWeights1, pOut, m_random);
+}
+
+void SimpleNeuralNetwork::mixGenom(
+    const float *pWeights0,
+    const float *pWeights1,
+    float *pOut,
+    SimpleNeuralRandom &random,
+    SimpleNeuralCrossover nCrossover
+) const {
+    int nSize = m_vWeights.size();
+    if (nCrossover == SimpleNeuralCrossover::Uniform) {
+        int i = 0;
+        while (i < nSize) {
+            // 64 decisions from one random number
+            uint64_t nBits = random.next();
+            int nCount = std::min(64, nSize - i);
+            for (int b = 0; b < nCount; ++b) {
+                pOut[i + b] = ((nBits >> b) & 1) == 0 ? pWeights1[i + b] : pWeights0[i + b];
+            }
+            i += nCount;
+        }
+        return;
+    }
+
+    // block crossover: every block is copied from one of parents
+    uint64_t nBits = 0;
+    int nBitsLeft = 0;
+    auto copyBlock = [&](int nOffset, int nCount) {
+        if (nBitsLeft == 0) {
+            nBits = random.next();
+            nBitsLeft = 64;
+        }
+        const float *pFrom = (nBits & 1) == 0 ? pWeights1 : pWeights0;
+        nBits >>= 1;
+        --nBitsLeft;
+        if (pFrom + nOffset != pOut + nOffset) {
+            std::memcpy(pOut + nOffset, pFrom + nOffset, nCount * sizeof(float));
+        }
+    };
+    copyBlock(0, m_nInputSize);
+    int nWeightOffset = m_nInputSize;
+    for (int nL = 1; nL < m_nLayersSize; ++nL) {
+        int nPrevLayerSize = m_vLayers[nL - 1];
+        int nLayerSize = m_vLayers[nL];
+        if (nCrossover == SimpleNeuralCrossover::Layers) {
+            copyBlock(nWeightOffset, nLayerSize * nPrevLayerSize);
+            nWeightOffset += nLayerSize * nPrevLayerSize;
+        } else {
+            for (int nN = 0; nN < nLayerSize; ++nN) {
+                copyBlock(nWeightOffset, nPrevLayerSize);
+                nWeightOffset += nPrevLayerSize;
+            }
         }
     }
 }
 
-float SimpleNeuralNetwork::randomWeight() {
-    return float((std::rand() % 200) - 100) / 100.0f;
+float SimpleNeuralNetwork::randomWeight(SimpleNeuralRandom &random) const {
+    return float(int(random.nextInt(200)) - 100) / 100.0f;
 }
 
 void SimpleNeuralNetwork::exportToCppFunction(const std::string &sFilename, const std::string &sFuncname, const std::string &sTop) {
@@ -327,6 +525,10 @@ void SimpleNeuralTrainingItemList::addItem(std::vector<float> vIn, std::vector<f
     m_vData.emplace_back(vIn, vOut);
 }
 
+void SimpleNeuralTrainingItemList::clear() {
+    m_vData.clear();
+}
+
 unsigned int SimpleNeuralTrainingItemList::size() const {
     return m_vData.size();
 }
@@ -345,18 +547,100 @@ std::vector<SimpleNeuralTrainingItem>::iterator SimpleNeuralTrainingItemList::en
 
 
 SimpleNeuralGenom::SimpleNeuralGenom(std::vector<float> vGenom, float nRating)
-    : m_vGenom{std::move(vGenom)}
-    , m_nRating{std::move(nRating)}
+    : m_nRating(nRating)
+    , m_vOwnWeights(std::move(vGenom))
+    , m_pWeights(m_vOwnWeights.data())
+    , m_nSize(m_vOwnWeights.size())
+    , m_bRejected(false)
+    , m_nSigma(0.01f)
 {
 
 }
 
-const std::vector<float> &SimpleNeuralGenom::getGenom() const {
-    return m_vGenom;
+SimpleNeuralGenom::SimpleNeuralGenom(float *pWeights, int nSize, float nRating)
+    : m_nRating(nRating)
+    , m_pWeights(pWeights)
+    , m_nSize(nSize)
+    , m_bRejected(false)
+    , m_nSigma(0.01f)
+{
+
+}
+
+SimpleNeuralGenom::SimpleNeuralGenom(const SimpleNeuralGenom &genom)
+    : m_nRating(genom.m_nRating)
+    , m_vOwnWeights(genom.m_pWeights, genom.m_pWeights + genom.m_nSize)
+    , m_pWeights(m_vOwnWeights.data())
+    , m_nSize(genom.m_nSize)
+    , m_bRejected(genom.m_bRejected)
+    , m_nSigma(genom.m_nSigma)
+{
+
+}
+
+SimpleNeuralGenom::SimpleNeuralGenom(SimpleNeuralGenom &&genom) noexcept
+    : m_nRating(genom.m_nRating)
+    , m_vOwnWeights(std::move(genom.m_vOwnWeights)) // the buffer is moved, the pointer stays valid
+    , m_pWeights(genom.m_pWeights)
+    , m_nSize(genom.m_nSize)
+    , m_bRejected(genom.m_bRejected)
+    , m_nSigma(genom.m_nSigma)
+{
+    genom.m_pWeights = nullptr;
+    genom.m_nSize = 0;
+}
+
+SimpleNeuralGenom &SimpleNeuralGenom::operator=(const SimpleNeuralGenom &genom) {
+    if (this != &genom) {
+        m_vOwnWeights.assign(genom.m_pWeights, genom.m_pWeights + genom.m_nSize);
+        m_pWeights = m_vOwnWeights.data();
+        m_nSize = genom.m_nSize;
+        m_nRating = genom.m_nRating;
+        m_bRejected = genom.m_bRejected;
+        m_nSigma = genom.m_nSigma;
+    }
+    return *this;
+}
+
+SimpleNeuralGenom &SimpleNeuralGenom::operator=(SimpleNeuralGenom &&genom) noexcept {
+    if (this != &genom) {
+        m_vOwnWeights = std::move(genom.m_vOwnWeights);
+        m_pWeights = genom.m_pWeights;
+        m_nSize = genom.m_nSize;
+        m_nRating = genom.m_nRating;
+        m_bRejected = genom.m_bRejected;
+        m_nSigma = genom.m_nSigma;
+        genom.m_pWeights = nullptr;
+        genom.m_nSize = 0;
+    }
+    return *this;
+}
+
+std::vector<float> SimpleNeuralGenom::getGenom() const {
+    return std::vector<float>(m_pWeights, m_pWeights + m_nSize);
+}
+
+const float *SimpleNeuralGenom::getWeights() const {
+    return m_pWeights;
+}
+
+float *SimpleNeuralGenom::getWeights() {
+    return m_pWeights;
+}
+
+int SimpleNeuralGenom::getSize() const {
+    return m_nSize;
 }
 
 void SimpleNeuralGenom::setGenom(const std::vector<float> &vGenom) {
-    m_vGenom = vGenom;
+    if (vGenom.size() != m_nSize) {
+        throw std::runtime_error("Incorrect genom size!");
+    }
+    this->setGenom(vGenom.data());
+}
+
+void SimpleNeuralGenom::setGenom(const float *pWeights) {
+    std::copy(pWeights, pWeights + m_nSize, m_pWeights);
 }
 
 float SimpleNeuralGenom::getRating() const {
@@ -370,30 +654,74 @@ void SimpleNeuralGenom::addRating(float nDiff) {
 
 void SimpleNeuralGenom::setRating(float nRating) {
     m_nRating = nRating;
+    m_bRejected = false;
+}
+
+bool SimpleNeuralGenom::isRejected() const {
+    return m_bRejected;
+}
+
+void SimpleNeuralGenom::reject(float nLowerBound) {
+    m_nRating = nLowerBound;
+    m_bRejected = true;
+}
+
+float SimpleNeuralGenom::getSigma() const {
+    return m_nSigma;
+}
+
+void SimpleNeuralGenom::setSigma(float nSigma) {
+    m_nSigma = nSigma;
+}
+
+bool SimpleNeuralGenom::isBetterThan(const SimpleNeuralGenom &genom) const {
+    if (m_bRejected != genom.m_bRejected) {
+        return genom.m_bRejected;
+    }
+    return m_nRating < genom.m_nRating;
 }
 
 void SimpleNeuralGenom::calculateRating(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData) {
+    this->calculateRatingOrReject(pNet, pTrainingData, std::numeric_limits<float>::infinity());
+}
+
+int SimpleNeuralGenom::calculateRatingOrReject(
+    SimpleNeuralNetwork *pNet,
+    SimpleNeuralTrainingItemList *pTrainingData,
+    float nRejectAbove
+) {
+    auto start = std::chrono::steady_clock::now();
     float nSumDiffs = 0.0f;
-    pNet->setGenom(m_vGenom);
+    float nSize = float(pTrainingData->size());
+    int nUsed = 0;
+    m_bRejected = false;
+    // the max of items is compared with the bound as is, the sum - as the mean
+    bool bMax = pNet->getLoss() == SimpleNeuralLoss::MaxError;
+    float nDivider = bMax ? 1.0f : nSize;
     std::vector<SimpleNeuralTrainingItem>::iterator it;
     for (it = pTrainingData->begin(); it != pTrainingData->end(); ++it) {
-        std::vector<float> vOutNet = pNet->calc(it->getIn());
-        std::vector<float> vOutExpected = it->getOut();
-        float ret = 0;
-        for (int i = 0; i < vOutNet.size(); i++) {
-            float x1 = vOutNet[i];
-            float x2 = vOutExpected[i];
-            ret += (x2 - x1)*(x2 - x1);
+        float nLoss = pNet->calcLoss(m_pWeights, it->getIn().data(), it->getOut().data());
+        nSumDiffs = bMax ? std::max(nSumDiffs, nLoss) : nSumDiffs + nLoss;
+        ++nUsed;
+        // the rest of items can only increase the sum
+        if (nSumDiffs / nDivider > nRejectAbove) {
+            m_bRejected = true;
+            break;
         }
-        ret = std::sqrt(ret);
-        nSumDiffs += ret;
     }
-    m_nRating = nSumDiffs / float(pTrainingData->size());
+    m_nRating = nSumDiffs / nDivider;
+    auto end = std::chrono::steady_clock::now();
+    pNet->addCalcStatistics(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(), nUsed);
+    return nUsed;
 }
 
 // ---------------------------------------------------------------------
 // SimpleNeuralGenomList
 
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
 SimpleNeuralGenomList::SimpleNeuralGenomList(int nBetterGenoms, int nMutateGenoms, int nMixGenoms) 
     : m_nBetterGenoms(nBetterGenoms)
     , m_nMutateGenoms(nMutateGenoms)
@@ -401,12 +729,268 @@ SimpleNeuralGenomList::SimpleNeuralGenomList(int nBetterGenoms, int nMutateGenom
     , m_nAllGenoms(m_nBetterGenoms + m_nMutateGenoms + m_nMixGenoms)
 {
     m_vGenoms.reserve(m_nAllGenoms);
+    m_pWorkerNetsSource = nullptr;
+    m_nGenomSize = 0;
+    m_nArenaStride = 0;
+    m_nRandomSeed = 0;
+    m_bRandomSeedSet = false;
+    m_nGeneration = 0;
+    m_nCrossover = SimpleNeuralCrossover::Uniform;
+    m_bSelfAdaptive = false;
+    m_nSelfAdaptiveTau = 0.3f;
+    m_nBetterIndex = 0;
+    m_bRacing = false;
+    m_nRacingUsedItems = 0;
+    m_nRacingAllItems = 0;
+    m_nMiniBatchSize = 0;
+    m_nMiniBatchRescore = 0;
+    m_nMiniBatchPosition = 0;
+    m_nMiniBatchEpoch = 0;
+    m_nScreeningProbeSize = 0;
+    m_nScreeningShare = 1.0f;
+    m_nScreeningAuditInterval = 0;
+    m_pProbeSource = nullptr;
+    m_nScreenedOut = 0;
+    m_nScreeningAudited = 0;
+    m_nScreeningFalseRejects = 0;
+    m_pRatingCacheNet = nullptr;
+    m_pRatingCacheData = nullptr;
+    m_nRatingCacheLoss = SimpleNeuralLoss::Euclidean;
+    m_pTelemetry = nullptr;
+    m_pBudget = nullptr;
+}
+
+SimpleNeuralGenomList::~SimpleNeuralGenomList() {
+    // defined here, where SimpleNeuralThreadPool is a complete type
+}
+
+void SimpleNeuralGenomList::setNumberOfThreads(int nThreads) {
+    if (nThreads < 1) {
+        nThreads = SimpleNeuralThreadPool::getDefaultNumberOfThreads();
+    }
+    if (nThreads == 1) {
+        m_pThreadPool.reset();
+    } else {
+        m_pThreadPool.reset(new SimpleNeuralThreadPool(nThreads));
+    }
+    m_vWorkerNets.clear();
+    m_pWorkerNetsSource = nullptr;
+}
+
+int SimpleNeuralGenomList::getNumberOfThreads() const {
+    return m_pThreadPool ? m_pThreadPool->getNumberOfThreads() : 1;
+}
+
+double SimpleNeuralGenomList::getBusySeconds() const {
+    return m_pThreadPool ? m_pThreadPool->getBusySeconds() : 0.0;
+}
+
+void SimpleNeuralGenomList::setRandomSeed(uint64_t nSeed) {
+    m_nRandomSeed = nSeed;
+    m_bRandomSeedSet = true;
+}
+
+uint64_t SimpleNeuralGenomList::getRandomSeed() const {
+    return m_nRandomSeed;
+}
+
+void SimpleNeuralGenomList::setCrossover(SimpleNeuralCrossover nCrossover) {
+    m_nCrossover = nCrossover;
+}
+
+void SimpleNeuralGenomList::setSelfAdaptiveMutation(bool bEnabled, float nTau) {
+    m_bSelfAdaptive = bEnabled;
+    m_nSelfAdaptiveTau = nTau;
+}
+
+void SimpleNeuralGenomList::setMiniBatch(int nBatchSize, int nRescoreInterval) {
+    m_nMiniBatchSize = nBatchSize;
+    m_nMiniBatchRescore = nRescoreInterval;
+}
+
+void SimpleNeuralGenomList::setPreScreening(int nProbeSize, float nShare, int nAuditInterval) {
+    m_nScreeningProbeSize = nProbeSize;
+    m_nScreeningShare = nShare;
+    m_nScreeningAuditInterval = nAuditInterval;
+    m_pProbeSource = nullptr;
+    m_nScreeningAudited = 0;
+    m_nScreeningFalseRejects = 0;
+}
+
+int SimpleNeuralGenomList::getNumberOfScreenedOut() const {
+    return m_nScreenedOut;
+}
+
+float SimpleNeuralGenomList::getScreeningFalseRejectRate() const {
+    if (m_nScreeningAudited == 0) {
+        return 0.0f;
+    }
+    return float(m_nScreeningFalseRejects) / float(m_nScreeningAudited);
+}
+
+void SimpleNeuralGenomList::setRacing(bool bRacing) {
+    m_bRacing = bRacing;
+}
+
+int SimpleNeuralGenomList::getNumberOfRejected() const {
+    int nRejected = 0;
+    for (int i = 0; i < m_vGenoms.size(); ++i) {
+        nRejected += m_vGenoms[i].isRejected() ? 1 : 0;
+    }
+    return nRejected;
+}
+
+float SimpleNeuralGenomList::getRacingSavedShare() const {
+    if (m_nRacingAllItems == 0) {
+        return 0.0f;
+    }
+    return 1.0f - float(m_nRacingUsedItems) / float(m_nRacingAllItems);
+}
+
+void SimpleNeuralGenomList::setRatingCache(int nCapacity) {
+    if (nCapacity <= 0) {
+        m_pRatingCache.reset();
+    } else {
+        m_pRatingCache.reset(new SimpleNeuralRatingCache(nCapacity));
+    }
+    m_pRatingCacheNet = nullptr;
+    m_pRatingCacheData = nullptr;
+    m_nRatingCacheLoss = SimpleNeuralLoss::Euclidean;
+}
+
+const SimpleNeuralRatingCache *SimpleNeuralGenomList::getRatingCache() const {
+    return m_pRatingCache.get();
 }
 
 void SimpleNeuralGenomList::fillRandom(SimpleNeuralNetwork *pNet) {
+    this->allocateArena(pNet->getGenomSize());
+    if (!m_bRandomSeedSet) {
+        this->setRandomSeed(std::rand());
+    }
+    m_nGeneration = 0;
+    m_nBetterIndex = 0;
+    m_pWorkerNetsSource = nullptr; // the network can be other (for example with other layers at the same address)
+
+    // every next genom is the previous one with one more mutation
+    const float *pPrev = pNet->getGenom().data();
     for (int i = 0; i < m_nAllGenoms; ++i) {
-        pNet->mutateGenom();
-        m_vGenoms.emplace_back(pNet->getGenom(), 100000.0f);
+        m_vGenoms[i].setGenom(pPrev);
+        SimpleNeuralRandom random(m_nRandomSeed, i);
+        pNet->mutateGenom(m_vGenoms[i].getWeights(), random);
+        pPrev = m_vGenoms[i].getWeights();
+    }
+}
+
+void SimpleNeuralGenomList::getCheckpoint(SimpleNeuralCheckpoint &checkpoint) const {
+    checkpoint.nRandomSeed = m_nRandomSeed;
+    checkpoint.nGeneration = m_nGeneration;
+    checkpoint.nGenomSize = m_nGenomSize;
+    checkpoint.vWeights.resize((size_t)m_vGenoms.size() * m_nGenomSize);
+    checkpoint.vRatings.resize(m_vGenoms.size());
+    checkpoint.vRejected.resize(m_vGenoms.size());
+    checkpoint.vSigmas.resize(m_vGenoms.size());
+    for (int i = 0; i < m_vGenoms.size(); ++i) {
+        const SimpleNeuralGenom &genom = m_vGenoms[i];
+        std::memcpy(checkpoint.vWeights.data() + (size_t)i * m_nGenomSize, genom.getWeights(), m_nGenomSize * sizeof(float));
+        checkpoint.vRatings[i] = genom.getRating();
+        checkpoint.vRejected[i] = genom.isRejected() ? 1 : 0;
+        checkpoint.vSigmas[i] = genom.getSigma();
+    }
+    checkpoint.nMiniBatchEpoch = m_nMiniBatchEpoch;
+    checkpoint.nMiniBatchPosition = m_nMiniBatchPosition;
+    checkpoint.vMiniBatchOrder.assign(m_vMiniBatchOrder.begin(), m_vMiniBatchOrder.end());
+}
+
+void SimpleNeuralGenomList::setCheckpoint(const SimpleNeuralCheckpoint &checkpoint, SimpleNeuralNetwork *pNet) {
+    // everything is checked before the first change, a bad checkpoint leaves the list as it was
+    if (checkpoint.nGenomSize != pNet->getGenomSize()) {
+        throw std::runtime_error("SimpleNeuralGenomList: expected checkpoint of genom size " + std::to_string(pNet->getGenomSize())
+            + ", but got " + std::to_string(checkpoint.nGenomSize));
+    }
+    if (checkpoint.vRatings.size() != m_nAllGenoms) {
+        throw std::runtime_error("SimpleNeuralGenomList: expected checkpoint of " + std::to_string(m_nAllGenoms)
+            + " genoms, but got " + std::to_string(checkpoint.vRatings.size()));
+    }
+    if (checkpoint.vWeights.size() != (size_t)m_nAllGenoms * checkpoint.nGenomSize) {
+        throw std::runtime_error("SimpleNeuralGenomList: expected " + std::to_string((size_t)m_nAllGenoms * checkpoint.nGenomSize)
+            + " weights in checkpoint, but got " + std::to_string(checkpoint.vWeights.size()));
+    }
+    if (checkpoint.vRejected.size() != m_nAllGenoms) {
+        throw std::runtime_error("SimpleNeuralGenomList: expected " + std::to_string(m_nAllGenoms)
+            + " rejected flags in checkpoint, but got " + std::to_string(checkpoint.vRejected.size()));
+    }
+    if (!checkpoint.vSigmas.empty() && checkpoint.vSigmas.size() != m_nAllGenoms) {
+        throw std::runtime_error("SimpleNeuralGenomList: expected " + std::to_string(m_nAllGenoms)
+            + " sigmas in checkpoint (or none), but got " + std::to_string(checkpoint.vSigmas.size()));
+    }
+    int nOrderSize = checkpoint.vMiniBatchOrder.size();
+    bool bOrderValid = checkpoint.nMiniBatchPosition >= 0 && checkpoint.nMiniBatchPosition <= nOrderSize;
+    for (int i = 0; bOrderValid && i < nOrderSize; ++i) {
+        bOrderValid = checkpoint.vMiniBatchOrder[i] >= 0 && checkpoint.vMiniBatchOrder[i] < nOrderSize;
+    }
+    if (!bOrderValid) {
+        throw std::runtime_error("SimpleNeuralGenomList: invalid order of mini-batch in checkpoint");
+    }
+    this->allocateArena(checkpoint.nGenomSize);
+    this->setRandomSeed(checkpoint.nRandomSeed);
+    m_nGeneration = checkpoint.nGeneration;
+    for (int i = 0; i < m_nAllGenoms; ++i) {
+        SimpleNeuralGenom &genom = m_vGenoms[i];
+        genom.setGenom(checkpoint.vWeights.data() + (size_t)i * m_nGenomSize);
+        genom.setRating(checkpoint.vRatings[i]);
+        if (checkpoint.vRejected[i]) {
+            genom.reject(checkpoint.vRatings[i]);
+        }
+        if (!checkpoint.vSigmas.empty()) {
+            genom.setSigma(checkpoint.vSigmas[i]);
+        }
+    }
+    m_nMiniBatchEpoch = checkpoint.nMiniBatchEpoch;
+    m_nMiniBatchPosition = checkpoint.nMiniBatchPosition;
+    m_vMiniBatchOrder.assign(checkpoint.vMiniBatchOrder.begin(), checkpoint.vMiniBatchOrder.end());
+    m_vParents.clear(); // pointed to genoms before the restore
+    this->updateBetterGenom(0, m_vGenoms.size());
+}
+
+long long SimpleNeuralGenomList::getGeneration() const {
+    return m_nGeneration;
+}
+
+void SimpleNeuralGenomList::setTelemetry(SimpleNeuralTelemetryWriter *pWriter) {
+    m_pTelemetry = pWriter;
+}
+
+const SimpleNeuralGenerationStats &SimpleNeuralGenomList::getGenerationStats() const {
+    return m_lastStats;
+}
+
+void SimpleNeuralGenomList::addPhaseSeconds(SimpleNeuralPhase nPhase, double nSeconds) {
+    m_currentStats.vSeconds[(int)nPhase] += nSeconds;
+}
+
+void SimpleNeuralGenomList::setBudget(const SimpleNeuralBudget *pBudget) {
+    m_pBudget = pBudget;
+}
+
+bool SimpleNeuralGenomList::skipWhenBudgetExhausted(SimpleNeuralGenom &genom) const {
+    if (m_pBudget == nullptr || !m_pBudget->isExhausted()) {
+        return false;
+    }
+    genom.reject(std::numeric_limits<float>::infinity());
+    return true;
+}
+
+void SimpleNeuralGenomList::allocateArena(int nGenomSize) {
+    // one allocation for the whole population
+    constexpr int nAlignFloats = 16; // 64 bytes
+    m_nGenomSize = nGenomSize;
+    m_nArenaStride = (m_nGenomSize + nAlignFloats - 1) / nAlignFloats * nAlignFloats;
+    m_vArena.assign(m_nAllGenoms * m_nArenaStride + nAlignFloats, 0.0f);
+    size_t nMisalign = reinterpret_cast<uintptr_t>(m_vArena.data()) % (nAlignFloats * sizeof(float));
+    float *pArena = m_vArena.data() + (nMisalign == 0 ? 0 : (nAlignFloats * sizeof(float) - nMisalign) / sizeof(float));
+    m_vGenoms.clear();
+    for (int i = 0; i < m_nAllGenoms; ++i) {
+        m_vGenoms.emplace_back(pArena + i * m_nArenaStride, m_nGenomSize, 100000.0f);
     }
 }
 
@@ -415,65 +999,630 @@ const std::vector<SimpleNeuralGenom> &SimpleNeuralGenomList::list() const {
 }
 
 float SimpleNeuralGenomList::getBetterRating() {
-    return m_vGenoms[0].getRating();
+    return m_vGenoms[m_nBetterIndex].getRating();
 }
 
 void SimpleNeuralGenomList::sort() {
-    std::sort(
-        m_vGenoms.begin(),
-        m_vGenoms.end(),
-        [](const SimpleNeuralGenom &a, const SimpleNeuralGenom &b) {
-            return a.getRating() < b.getRating();
-        });
+    auto start = std::chrono::steady_clock::now();
+    // only the better genoms must be in order, the rest will be replaced by children
+    auto compare = [](const SimpleNeuralGenom &a, const SimpleNeuralGenom &b) {
+        return a.isBetterThan(b);
+    };
+    if (m_nBetterGenoms < m_vGenoms.size()) {
+        std::nth_element(m_vGenoms.begin(), m_vGenoms.begin() + m_nBetterGenoms, m_vGenoms.end(), compare);
+    }
+    std::sort(m_vGenoms.begin(), m_vGenoms.begin() + std::min<size_t>(m_nBetterGenoms, m_vGenoms.size()), compare);
+    m_nBetterIndex = 0;
+    this->addPhaseSeconds(SimpleNeuralPhase::Sort, secondsSince(start));
+}
+
+void SimpleNeuralGenomList::updateBetterGenom(int nBegin, int nEnd) {
+    if (m_nBetterIndex >= nBegin && m_nBetterIndex < nEnd) {
+        // rating of the better genom was changed
+        nBegin = 0;
+        nEnd = m_vGenoms.size();
+        m_nBetterIndex = nBegin;
+    }
+    for (int i = nBegin; i < nEnd; ++i) {
+        if (m_vGenoms[i].isBetterThan(m_vGenoms[m_nBetterIndex])) {
+            m_nBetterIndex = i;
+        }
+    }
 }
 
 void SimpleNeuralGenomList::printFirstRatings(int nNumber) {
+    auto start = std::chrono::steady_clock::now();
     for (int nG = 0; nG < nNumber; nG++) {
         std::cout << "genom[" << nG << "].rating = " << m_vGenoms[nG].getRating() << std::endl;
     }
+    this->addPhaseSeconds(SimpleNeuralPhase::IO, secondsSince(start));
 }
 
 void SimpleNeuralGenomList::mutateAndMix(SimpleNeuralNetwork *pNet) {
-    // assert(nBetterGenoms + nMutateGenoms <= nGenoms);
-    int nOffset = m_nBetterGenoms;
-    // mutate
-    for (int i = 0; i < m_nMutateGenoms; i++) {
-        int n0 = std::rand() % m_nBetterGenoms;
-        pNet->setGenom(m_vGenoms[n0].getGenom());
-        pNet->mutateGenom();
-        m_vGenoms[nOffset + i].setGenom(pNet->getGenom());
+    // assert(nBetterGenoms + nMutateGenoms + nMixGenoms == nGenoms);
+    ++m_nGeneration;
+    m_vParents.resize(m_nMutateGenoms + m_nMixGenoms);
+    auto produce = [&](int /* nWorker */, int nIndex) {
+        int nChild = m_nBetterGenoms + nIndex;
+        SimpleNeuralRandom random(m_nRandomSeed, (uint64_t)m_nGeneration * m_nAllGenoms + nChild);
+        SimpleNeuralGenom &child = m_vGenoms[nChild];
+        if (nIndex < m_nMutateGenoms) {
+            // mutate
+            int n0 = random.nextInt(m_nBetterGenoms);
+            child.setGenom(m_vGenoms[n0].getWeights());
+            if (m_bSelfAdaptive) {
+                // log-normal step of the step, limited so the genom does not freeze or explode
+                float nGaussian;
+                random.fillGaussian(&nGaussian, 1);
+                float nSigma = m_vGenoms[n0].getSigma() * std::exp(m_nSelfAdaptiveTau * nGaussian);
+                child.setSigma(std::min(std::max(nSigma, 1e-5f), 1.0f));
+                pNet->mutateGenom(child.getWeights(), random, child.getSigma());
+            } else {
+                pNet->mutateGenom(child.getWeights(), random);
+            }
+            m_vParents[nIndex] = m_vGenoms[n0].getWeights();
+        } else {
+            // mix
+            int n0 = random.nextInt(m_nBetterGenoms);
+            int n1 = random.nextInt(m_nBetterGenoms);
+            pNet->mixGenom(m_vGenoms[n0].getWeights(), m_vGenoms[n1].getWeights(), child.getWeights(), random, m_nCrossover);
+            child.setSigma(std::sqrt(m_vGenoms[n0].getSigma() * m_vGenoms[n1].getSigma()));
+            m_vParents[nIndex] = m_vGenoms[n0].getWeights();
+        }
+    };
+    // mutated and mixed children one after another, so the phases are timed separately
+    int nChildren = m_nMutateGenoms + m_nMixGenoms;
+    auto start = std::chrono::steady_clock::now();
+    for (int nPhase = 0; nPhase < 2; ++nPhase) {
+        int nBegin = nPhase == 0 ? 0 : m_nMutateGenoms;
+        int nEnd = nPhase == 0 ? m_nMutateGenoms : nChildren;
+        if (m_pThreadPool) {
+            m_pThreadPool->parallelFor(nBegin, nEnd, produce);
+        } else {
+            for (int i = nBegin; i < nEnd; ++i) {
+                produce(0, i);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        this->addPhaseSeconds(nPhase == 0 ? SimpleNeuralPhase::Mutation : SimpleNeuralPhase::Crossover,
+            std::chrono::duration<double>(end - start).count());
+        start = end;
     }
+}
 
-    // assert(nBetterGenoms + 2 * nMutateGenoms <= nGenoms);
-    nOffset += m_nMutateGenoms;
-    for (int i = 0; i < m_nMixGenoms; i++) {
-        int n0 = std::rand() % m_nBetterGenoms;
-        int n1 = std::rand() % m_nBetterGenoms;
-        pNet->setGenom(m_vGenoms[n0].getGenom());
-        pNet->mixGenom(m_vGenoms[n1].getGenom());
-        m_vGenoms[nOffset + i].setGenom(pNet->getGenom());
+bool SimpleNeuralGenomList::replaceWorstGenom(const float *pWeights, float nRating) {
+    if (m_vGenoms.empty()) {
+        return false;
+    }
+    int nWorst = 0;
+    for (int i = 0; i < m_vGenoms.size(); ++i) {
+        const SimpleNeuralGenom &genom = m_vGenoms[i];
+        if (genom.getRating() == nRating && std::memcmp(genom.getWeights(), pWeights, m_nGenomSize * sizeof(float)) == 0) {
+            return false; // copy of the genom
+        }
+        if (m_vGenoms[nWorst].isBetterThan(genom)) {
+            nWorst = i;
+        }
+    }
+    SimpleNeuralGenom &worst = m_vGenoms[nWorst];
+    if (!worst.isRejected() && worst.getRating() <= nRating) {
+        return false;
+    }
+    worst.setGenom(pWeights);
+    worst.setRating(nRating);
+    if (worst.isBetterThan(m_vGenoms[m_nBetterIndex])) {
+        m_nBetterIndex = nWorst;
     }
+    return true;
 }
 
 const SimpleNeuralGenom &SimpleNeuralGenomList::getBetterGenom() {
-    this->sort();
-    return m_vGenoms[0];
+    return m_vGenoms[m_nBetterIndex];
 }
 
 void SimpleNeuralGenomList::calculateRatingForAll(
     SimpleNeuralNetwork *pNet,
     SimpleNeuralTrainingItemList *pTrainingData
 ) {
-    for (auto it = m_vGenoms.begin(); it != m_vGenoms.end(); ++it) {
-        it->calculateRating(pNet, pTrainingData);
-    }
+    auto start = std::chrono::steady_clock::now();
+    this->calculateRatingForRange(pNet, pTrainingData, 0, m_vGenoms.size());
+    this->finishEvaluation(secondsSince(start), m_vGenoms.size(), false);
 }
 
 void SimpleNeuralGenomList::calculateRatingForMutatedAndMixed(
     SimpleNeuralNetwork *pNet,
     SimpleNeuralTrainingItemList *pTrainingData
 ) {
-    for (auto it = m_vGenoms.begin() + m_nBetterGenoms; it != m_vGenoms.end(); ++it) {
-        it->calculateRating(pNet, pTrainingData);
+    auto start = std::chrono::steady_clock::now();
+    int nBegin = m_nBetterGenoms;
+    int nEnd = m_vGenoms.size();
+    m_nScreenedOut = 0;
+    SimpleNeuralTrainingItemList *pFullData = pTrainingData;
+    if (m_nMiniBatchSize > 0 && m_nMiniBatchSize < pTrainingData->size()) {
+        if (m_nMiniBatchRescore > 0 && m_nGeneration % m_nMiniBatchRescore == 0) {
+            // better genoms were rated on other batches: all genoms on the full data
+            nBegin = 0;
+        } else {
+            this->fillMiniBatch(pTrainingData);
+            pTrainingData = m_pMiniBatch.get();
+        }
+    }
+    if (nBegin != 0) {
+        nEnd = this->preScreen(pNet, pFullData);
+    }
+    if (nBegin == 0 || !m_bRacing) {
+        this->calculateRatingForRange(pNet, pTrainingData, nBegin, nEnd);
+    } else {
+        this->calculateRatingWithRacing(pNet, pTrainingData, nEnd);
+    }
+    int nEvaluations = nEnd - nBegin;
+    if (nEnd < m_vGenoms.size() && m_nScreeningAuditInterval > 0 && m_nGeneration % m_nScreeningAuditInterval == 0) {
+        nEvaluations += this->auditScreening(pNet, pFullData, pTrainingData, nEnd);
+    }
+    this->finishEvaluation(secondsSince(start), nEvaluations, true);
+}
+
+void SimpleNeuralGenomList::calculateRatingWithRacing(
+    SimpleNeuralNetwork *pNet,
+    SimpleNeuralTrainingItemList *pTrainingData,
+    int nEnd
+) {
+    // a child worse than the worst of better genoms can not get into better genoms
+    float nRejectAbove = -std::numeric_limits<float>::infinity();
+    for (int i = 0; i < m_nBetterGenoms; ++i) {
+        nRejectAbove = std::max(nRejectAbove, m_vGenoms[i].getRating());
+    }
+    std::vector<int> vToRate = this->takeRatingsFromCache(pNet, pTrainingData, m_nBetterGenoms, nEnd);
+    std::vector<int> vUsed(m_vGenoms.size(), 0);
+    for (int i = m_nBetterGenoms; i < nEnd; ++i) {
+        vUsed[i] = pTrainingData->size(); // rated before
+    }
+    auto rate = [&](SimpleNeuralNetwork *pWorkerNet, int nIndex) {
+        if (this->skipWhenBudgetExhausted(m_vGenoms[nIndex])) {
+            vUsed[nIndex] = 0;
+            return;
+        }
+        vUsed[nIndex] = m_vGenoms[nIndex].calculateRatingOrReject(pWorkerNet, pTrainingData, nRejectAbove);
+    };
+    if (!m_pThreadPool) {
+        for (int i = 0; i < vToRate.size(); ++i) {
+            rate(pNet, vToRate[i]);
+        }
+    } else {
+        this->prepareWorkerNets(pNet);
+        m_pThreadPool->parallelFor(0, vToRate.size(), [&](int nWorker, int nIndex) {
+            rate(nWorker == 0 ? pNet : &m_vWorkerNets[nWorker - 1], vToRate[nIndex]);
+        });
+        for (int i = 0; i < m_vWorkerNets.size(); ++i) {
+            pNet->mergeCalcStatistics(m_vWorkerNets[i]);
+        }
+    }
+    this->putRatingsToCache(vToRate);
+    m_nRacingUsedItems = 0;
+    for (int i = m_nBetterGenoms; i < nEnd; ++i) {
+        m_nRacingUsedItems += vUsed[i];
+    }
+    m_nRacingAllItems = (long long)(nEnd - m_nBetterGenoms) * pTrainingData->size();
+    this->updateBetterGenom(m_nBetterGenoms, nEnd);
+}
+
+int SimpleNeuralGenomList::preScreen(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData) {
+    int nChildren = m_vGenoms.size() - m_nBetterGenoms;
+    int nPromoted = std::max(1, int(std::ceil(m_nScreeningShare * nChildren)));
+    if (m_nScreeningProbeSize <= 0 || m_nScreeningProbeSize >= pTrainingData->size() || nPromoted >= nChildren) {
+        return m_vGenoms.size();
+    }
+    if (m_pProbeSource != pTrainingData || m_pProbeData->size() != m_nScreeningProbeSize) {
+        // evenly spaced items, the same for all generations, so probe ratings of children are comparable
+        m_pProbeData.reset(new SimpleNeuralTrainingItemList(pTrainingData->getNumberOfIn(), pTrainingData->getNumberOfOut()));
+        for (int i = 0; i < m_nScreeningProbeSize; ++i) {
+            const SimpleNeuralTrainingItem &item = pTrainingData->begin()[(long long)i * pTrainingData->size() / m_nScreeningProbeSize];
+            m_pProbeData->addItem(item.getIn(), item.getOut());
+        }
+        m_pProbeSource = pTrainingData;
+    }
+
+    auto rateOnProbe = [&](SimpleNeuralNetwork *pWorkerNet, int nIndex) {
+        if (!this->skipWhenBudgetExhausted(m_vGenoms[nIndex])) {
+            m_vGenoms[nIndex].calculateRating(pWorkerNet, m_pProbeData.get());
+        }
+    };
+    if (!m_pThreadPool) {
+        for (int i = m_nBetterGenoms; i < m_vGenoms.size(); ++i) {
+            rateOnProbe(pNet, i);
+        }
+    } else {
+        this->prepareWorkerNets(pNet);
+        m_pThreadPool->parallelFor(m_nBetterGenoms, m_vGenoms.size(), [&](int nWorker, int nIndex) {
+            rateOnProbe(nWorker == 0 ? pNet : &m_vWorkerNets[nWorker - 1], nIndex);
+        });
+        for (int i = 0; i < m_vWorkerNets.size(); ++i) {
+            pNet->mergeCalcStatistics(m_vWorkerNets[i]);
+        }
+    }
+
+    // the promising children go first (the views and their parents), the rest are screened out
+    std::vector<int> vOrder(nChildren);
+    for (int i = 0; i < nChildren; ++i) {
+        vOrder[i] = i;
+    }
+    std::stable_sort(vOrder.begin(), vOrder.end(), [&](int a, int b) {
+        return m_vGenoms[m_nBetterGenoms + a].isBetterThan(m_vGenoms[m_nBetterGenoms + b]);
+    });
+    std::vector<SimpleNeuralGenom> vChildren;
+    vChildren.reserve(nChildren);
+    for (int i = 0; i < nChildren; ++i) {
+        vChildren.push_back(std::move(m_vGenoms[m_nBetterGenoms + i]));
+    }
+    std::vector<const float *> vParents(m_vParents);
+    for (int i = 0; i < nChildren; ++i) {
+        m_vGenoms[m_nBetterGenoms + i] = std::move(vChildren[vOrder[i]]);
+        if (vParents.size() == nChildren) {
+            m_vParents[i] = vParents[vOrder[i]];
+        }
+    }
+    for (int i = m_nBetterGenoms + nPromoted; i < m_vGenoms.size(); ++i) {
+        SimpleNeuralGenom &genom = m_vGenoms[i];
+        if (!genom.isRejected()) {
+            genom.reject(genom.getRating());
+        }
+    }
+    m_nScreenedOut = nChildren - nPromoted;
+    return m_nBetterGenoms + nPromoted;
+}
+
+int SimpleNeuralGenomList::auditScreening(
+    SimpleNeuralNetwork *pNet,
+    SimpleNeuralTrainingItemList *pFullData,
+    SimpleNeuralTrainingItemList *pSelectionData,
+    int nScreenedOutBegin
+) {
+    // the screened out child is a false reject if on the full data it's better than the worst
+    // of better genoms chosen from the others (parents and promoted children)
+    std::vector<int> vBetter;
+    for (int i = 0; i < nScreenedOutBegin; ++i) {
+        if (!m_vGenoms[i].isRejected()) {
+            vBetter.push_back(i);
+        }
+    }
+    if (vBetter.size() > m_nBetterGenoms) {
+        std::nth_element(vBetter.begin(), vBetter.begin() + m_nBetterGenoms - 1, vBetter.end(), [&](int a, int b) {
+            return m_vGenoms[a].getRating() < m_vGenoms[b].getRating();
+        });
+        vBetter.resize(m_nBetterGenoms);
+    }
+    // the audit is rated by other views of the same weights, so ratings and rejects of the list
+    // (and the selection) are the same as without the audit
+    bool bRateBetter = pFullData != pSelectionData; // the mini-batch: better genoms on the full data too
+    std::vector<SimpleNeuralGenom> vAudit;
+    vAudit.reserve(m_vGenoms.size() - nScreenedOutBegin + vBetter.size());
+    for (int i = nScreenedOutBegin; i < m_vGenoms.size(); ++i) {
+        vAudit.emplace_back(m_vGenoms[i].getWeights(), m_nGenomSize, 0.0f);
+    }
+    for (int i = 0; i < vBetter.size() && bRateBetter; ++i) {
+        vAudit.emplace_back(m_vGenoms[vBetter[i]].getWeights(), m_nGenomSize, 0.0f);
+    }
+    auto rate = [&](SimpleNeuralNetwork *pWorkerNet, int nIndex) {
+        if (!this->skipWhenBudgetExhausted(vAudit[nIndex])) {
+            vAudit[nIndex].calculateRating(pWorkerNet, pFullData);
+        }
+    };
+    if (!m_pThreadPool) {
+        for (int i = 0; i < vAudit.size(); ++i) {
+            rate(pNet, i);
+        }
+    } else {
+        this->prepareWorkerNets(pNet);
+        m_pThreadPool->parallelFor(0, vAudit.size(), [&](int nWorker, int nIndex) {
+            rate(nWorker == 0 ? pNet : &m_vWorkerNets[nWorker - 1], nIndex);
+        });
+        for (int i = 0; i < m_vWorkerNets.size(); ++i) {
+            pNet->mergeCalcStatistics(m_vWorkerNets[i]);
+        }
+    }
+
+    int nScreenedOut = m_vGenoms.size() - nScreenedOutBegin;
+    float nWorstBetter = std::numeric_limits<float>::infinity();
+    if (vBetter.size() >= m_nBetterGenoms) {
+        nWorstBetter = -std::numeric_limits<float>::infinity();
+        for (int i = 0; i < vBetter.size(); ++i) {
+            if (bRateBetter && vAudit[nScreenedOut + i].isRejected()) {
+                return vAudit.size(); // skipped by the budget, the bound is not known
+            }
+            float nRating = bRateBetter ? vAudit[nScreenedOut + i].getRating() : m_vGenoms[vBetter[i]].getRating();
+            nWorstBetter = std::max(nWorstBetter, nRating);
+        }
+    }
+    for (int i = 0; i < nScreenedOut; ++i) {
+        if (vAudit[i].isRejected()) {
+            continue; // skipped by the budget
+        }
+        ++m_nScreeningAudited;
+        if (vAudit[i].getRating() < nWorstBetter) {
+            ++m_nScreeningFalseRejects;
+        }
+    }
+    return vAudit.size();
+}
+
+void SimpleNeuralGenomList::fillMiniBatch(SimpleNeuralTrainingItemList *pTrainingData) {
+    // the order of items is shuffled once per epoch and batches are taken one by one,
+    // so every item is used once per epoch
+    int nSize = pTrainingData->size();
+    if (m_vMiniBatchOrder.size() != nSize) {
+        m_vMiniBatchOrder.resize(nSize);
+        m_nMiniBatchPosition = nSize;
+    }
+    if (!m_pMiniBatch) {
+        m_pMiniBatch.reset(new SimpleNeuralTrainingItemList(pTrainingData->getNumberOfIn(), pTrainingData->getNumberOfOut()));
+    }
+    m_pMiniBatch->clear();
+    while (m_pMiniBatch->size() < m_nMiniBatchSize) {
+        if (m_nMiniBatchPosition >= nSize) {
+            SimpleNeuralRandom random(m_nRandomSeed, (uint64_t(1) << 63) | uint64_t(m_nMiniBatchEpoch));
+            for (int i = 0; i < nSize; ++i) {
+                m_vMiniBatchOrder[i] = i;
+            }
+            for (int i = nSize - 1; i > 0; --i) {
+                std::swap(m_vMiniBatchOrder[i], m_vMiniBatchOrder[random.nextInt(i + 1)]);
+            }
+            m_nMiniBatchPosition = 0;
+            ++m_nMiniBatchEpoch;
+        }
+        const SimpleNeuralTrainingItem &item = pTrainingData->begin()[m_vMiniBatchOrder[m_nMiniBatchPosition]];
+        m_pMiniBatch->addItem(item.getIn(), item.getOut());
+        ++m_nMiniBatchPosition;
+    }
+}
+
+void SimpleNeuralGenomList::prepareWorkerNets(SimpleNeuralNetwork *pNet) {
+    int nThreads = m_pThreadPool->getNumberOfThreads();
+    if (m_pWorkerNetsSource != pNet || m_vWorkerNets.size() != nThreads - 1) {
+        m_vWorkerNets.clear();
+        m_vWorkerNets.reserve(nThreads - 1);
+        for (int i = 1; i < nThreads; ++i) {
+            m_vWorkerNets.emplace_back(*pNet);
+        }
+        m_pWorkerNetsSource = pNet;
+    }
+    // the loss can be changed after the copy
+    for (int i = 0; i < m_vWorkerNets.size(); ++i) {
+        m_vWorkerNets[i].setLoss(pNet->getLoss());
+    }
+}
+
+void SimpleNeuralGenomList::calculateRatingForRange(
+    SimpleNeuralNetwork *pNet,
+    SimpleNeuralTrainingItemList *pTrainingData,
+    int nBegin,
+    int nEnd
+) {
+    std::vector<int> vToRate = this->takeRatingsFromCache(pNet, pTrainingData, nBegin, nEnd);
+    if (!m_pThreadPool) {
+        for (int i = 0; i < vToRate.size(); ++i) {
+            if (!this->skipWhenBudgetExhausted(m_vGenoms[vToRate[i]])) {
+                m_vGenoms[vToRate[i]].calculateRating(pNet, pTrainingData);
+            }
+        }
+        this->putRatingsToCache(vToRate);
+        this->updateBetterGenom(nBegin, nEnd);
+        return;
+    }
+
+    // every genom is rated independently by the same code,
+    // so the ratings are exactly the same as in serial mode
+    this->prepareWorkerNets(pNet);
+    m_pThreadPool->parallelFor(0, vToRate.size(), [&](int nWorker, int nIndex) {
+        SimpleNeuralNetwork *pWorkerNet = nWorker == 0 ? pNet : &m_vWorkerNets[nWorker - 1];
+        if (!this->skipWhenBudgetExhausted(m_vGenoms[vToRate[nIndex]])) {
+            m_vGenoms[vToRate[nIndex]].calculateRating(pWorkerNet, pTrainingData);
+        }
+    });
+    for (int i = 0; i < m_vWorkerNets.size(); ++i) {
+        pNet->mergeCalcStatistics(m_vWorkerNets[i]);
+    }
+    this->putRatingsToCache(vToRate);
+    this->updateBetterGenom(nBegin, nEnd);
+}
+
+std::vector<int> SimpleNeuralGenomList::takeRatingsFromCache(
+    SimpleNeuralNetwork *pNet,
+    SimpleNeuralTrainingItemList *pTrainingData,
+    int nBegin,
+    int nEnd
+) {
+    std::vector<int> vToRate;
+    vToRate.reserve(nEnd - nBegin);
+    // the content of the mini-batch is changed every generation, so its ratings are not comparable
+    bool bUseCache = m_pRatingCache && pTrainingData != m_pMiniBatch.get();
+    if (!bUseCache) {
+        m_vHashes.clear();
+        for (int i = nBegin; i < nEnd; ++i) {
+            vToRate.push_back(i);
+        }
+        return vToRate;
+    }
+    if (m_pRatingCacheNet != pNet || m_pRatingCacheData != pTrainingData || m_nRatingCacheLoss != pNet->getLoss()) {
+        m_pRatingCache->clear();
+        m_pRatingCacheNet = pNet;
+        m_nRatingCacheLoss = pNet->getLoss();
+        m_pRatingCacheData = pTrainingData;
+    }
+    m_vHashes.resize(m_vGenoms.size());
+    for (int i = nBegin; i < nEnd; ++i) {
+        SimpleNeuralGenom &genom = m_vGenoms[i];
+        m_vHashes[i] = SimpleNeuralRatingCache::hash(genom.getWeights(), genom.getSize());
+        float nRating;
+        if (m_pRatingCache->find(m_vHashes[i], genom.getWeights(), genom.getSize(), nRating)) {
+            genom.setRating(nRating);
+        } else {
+            vToRate.push_back(i);
+        }
+    }
+    return vToRate;
+}
+
+void SimpleNeuralGenomList::putRatingsToCache(const std::vector<int> &vRated) {
+    if (m_vHashes.empty()) {
+        return; // the cache was not used
+    }
+    for (int i = 0; i < vRated.size(); ++i) {
+        const SimpleNeuralGenom &genom = m_vGenoms[vRated[i]];
+        if (!genom.isRejected()) { // rating of rejected genom is only the lower bound
+            m_pRatingCache->insert(m_vHashes[vRated[i]], genom.getWeights(), genom.getSize(), genom.getRating());
+        }
+    }
+}
+
+void SimpleNeuralGenomList::calculateRatingForAll(SimpleNeuralBatchEvaluator *pEvaluator) {
+    auto start = std::chrono::steady_clock::now();
+    this->calculateRatingForRange(pEvaluator, 0, m_vGenoms.size());
+    this->finishEvaluation(secondsSince(start), m_vGenoms.size(), false);
+}
+
+void SimpleNeuralGenomList::calculateRatingForMutatedAndMixed(SimpleNeuralBatchEvaluator *pEvaluator) {
+    auto start = std::chrono::steady_clock::now();
+    this->calculateRatingForRange(pEvaluator, m_nBetterGenoms, m_vGenoms.size());
+    this->finishEvaluation(secondsSince(start), m_vGenoms.size() - m_nBetterGenoms, true);
+}
+
+void SimpleNeuralGenomList::calculateRatingForRange(SimpleNeuralBatchEvaluator *pEvaluator, int nBegin, int nEnd) {
+    int nBlock = pEvaluator->getGenomsBlock();
+    int nBlocks = (nEnd - nBegin + nBlock - 1) / nBlock;
+    auto rateBlock = [&](int nWorker, int nIndex) {
+        int nFirst = nBegin + nIndex * nBlock;
+        int nCount = std::min(nBlock, nEnd - nFirst);
+        if (m_pBudget != nullptr && m_pBudget->isExhausted()) {
+            for (int i = nFirst; i < nFirst + nCount; ++i) {
+                this->skipWhenBudgetExhausted(m_vGenoms[i]);
+            }
+            return;
+        }
+        pEvaluator->calculateRating(m_vGenoms.data() + nFirst, nCount, nWorker);
+    };
+    if (!m_pThreadPool) {
+        for (int i = 0; i < nBlocks; ++i) {
+            rateBlock(0, i);
+        }
+    } else {
+        pEvaluator->setNumberOfWorkers(m_pThreadPool->getNumberOfThreads());
+        m_pThreadPool->parallelFor(0, nBlocks, rateBlock);
     }
-}
\ No newline at end of file
+    this->updateBetterGenom(nBegin, nEnd);
+}
+
+void SimpleNeuralGenomList::calculateRatingForAll(SimpleNeuralGramEvaluator *pEvaluator) {
+    auto start = std::chrono::steady_clock::now();
+    this->calculateRatingForRange(pEvaluator, 0, m_vGenoms.size());
+    this->finishEvaluation(secondsSince(start), m_vGenoms.size(), false);
+}
+
+void SimpleNeuralGenomList::calculateRatingForMutatedAndMixed(SimpleNeuralGramEvaluator *pEvaluator) {
+    auto start = std::chrono::steady_clock::now();
+    this->calculateRatingForRange(pEvaluator, m_nBetterGenoms, m_vGenoms.size());
+    this->finishEvaluation(secondsSince(start), m_vGenoms.size() - m_nBetterGenoms, true);
+}
+
+void SimpleNeuralGenomList::calculateRatingForRange(SimpleNeuralGramEvaluator *pEvaluator, int nBegin, int nEnd) {
+    if (!m_pThreadPool) {
+        for (int i = nBegin; i < nEnd; ++i) {
+            if (!this->skipWhenBudgetExhausted(m_vGenoms[i])) {
+                pEvaluator->calculateRating(m_vGenoms[i], 0);
+            }
+        }
+    } else {
+        pEvaluator->setNumberOfWorkers(m_pThreadPool->getNumberOfThreads());
+        m_pThreadPool->parallelFor(nBegin, nEnd, [&](int nWorker, int nIndex) {
+            if (!this->skipWhenBudgetExhausted(m_vGenoms[nIndex])) {
+                pEvaluator->calculateRating(m_vGenoms[nIndex], nWorker);
+            }
+        });
+    }
+    this->updateBetterGenom(nBegin, nEnd);
+}
+
+#ifndef _WIN32
+void SimpleNeuralGenomList::calculateRatingForAll(SimpleNeuralRemoteCoordinator *pCoordinator) {
+    auto start = std::chrono::steady_clock::now();
+    pCoordinator->calculateRating(m_vGenoms.data(), m_vGenoms.size());
+    this->updateBetterGenom(0, m_vGenoms.size());
+    this->finishEvaluation(secondsSince(start), m_vGenoms.size(), false);
+}
+
+void SimpleNeuralGenomList::calculateRatingForMutatedAndMixed(SimpleNeuralRemoteCoordinator *pCoordinator) {
+    auto start = std::chrono::steady_clock::now();
+    pCoordinator->calculateRating(m_vGenoms.data() + m_nBetterGenoms, m_vGenoms.size() - m_nBetterGenoms);
+    this->updateBetterGenom(m_nBetterGenoms, m_vGenoms.size());
+    this->finishEvaluation(secondsSince(start), m_vGenoms.size() - m_nBetterGenoms, true);
+}
+#endif // _WIN32
+
+void SimpleNeuralGenomList::calculateRatingForMutatedAndMixed(SimpleNeuralDeltaEvaluator *pEvaluator) {
+    auto start = std::chrono::steady_clock::now();
+    int nChildren = m_nMutateGenoms + m_nMixGenoms;
+    if (m_vParents.size() != nChildren) {
+        // no mutateAndMix() yet - parents are unknown
+        m_vParents.assign(nChildren, nullptr);
+    }
+    std::vector<const float *> vParents;
+    for (int i = 0; i < nChildren; ++i) {
+        if (m_vParents[i] != nullptr && std::find(vParents.begin(), vParents.end(), m_vParents[i]) == vParents.end()) {
+            vParents.push_back(m_vParents[i]);
+        }
+    }
+    pEvaluator->setParents(vParents);
+    if (!m_pThreadPool) {
+        for (int i = 0; i < pEvaluator->getNumberOfParents(); ++i) {
+            pEvaluator->prepareParent(i, 0);
+        }
+        for (int i = 0; i < nChildren; ++i) {
+            if (!this->skipWhenBudgetExhausted(m_vGenoms[m_nBetterGenoms + i])) {
+                pEvaluator->calculateRating(m_vGenoms[m_nBetterGenoms + i], m_vParents[i], 0);
+            }
+        }
+    } else {
+        pEvaluator->setNumberOfWorkers(m_pThreadPool->getNumberOfThreads());
+        m_pThreadPool->parallelFor(0, pEvaluator->getNumberOfParents(), [&](int nWorker, int nIndex) {
+            pEvaluator->prepareParent(nIndex, nWorker);
+        });
+        m_pThreadPool->parallelFor(0, nChildren, [&](int nWorker, int nIndex) {
+            if (!this->skipWhenBudgetExhausted(m_vGenoms[m_nBetterGenoms + nIndex])) {
+                pEvaluator->calculateRating(m_vGenoms[m_nBetterGenoms + nIndex], m_vParents[nIndex], nWorker);
+            }
+        });
+    }
+    this->updateBetterGenom(m_nBetterGenoms, m_vGenoms.size());
+    this->finishEvaluation(secondsSince(start), nChildren, true);
+}
+
+void SimpleNeuralGenomList::finishEvaluation(double nSeconds, int nEvaluations, bool bEndOfGeneration) {
+    m_currentStats.vSeconds[(int)SimpleNeuralPhase::Evaluation] += nSeconds;
+    m_currentStats.nEvaluations += nEvaluations;
+    if (!bEndOfGeneration) {
+        return;
+    }
+    // rejected and stopped genoms have no real rating (infinity), they are not in the stats
+    m_vStatsRatings.clear();
+    for (int i = 0; i < m_vGenoms.size(); ++i) {
+        if (!m_vGenoms[i].isRejected() && std::isfinite(m_vGenoms[i].getRating())) {
+            m_vStatsRatings.push_back(m_vGenoms[i].getRating());
+        }
+    }
+    m_currentStats.nGeneration = m_nGeneration;
+    m_currentStats.nBetterRating = m_vGenoms[m_nBetterIndex].getRating();
+    m_currentStats.nMedianRating = std::numeric_limits<float>::quiet_NaN();
+    m_currentStats.nWorstRating = std::numeric_limits<float>::quiet_NaN();
+    if (!m_vStatsRatings.empty()) {
+        int nMedian = m_vStatsRatings.size() / 2;
+        std::nth_element(m_vStatsRatings.begin(), m_vStatsRatings.begin() + nMedian, m_vStatsRatings.end());
+        m_currentStats.nMedianRating = m_vStatsRatings[nMedian];
+        m_currentStats.nWorstRating = *std::max_element(m_vStatsRatings.begin(), m_vStatsRatings.end());
+    }
+    m_lastStats = m_currentStats;
+    m_currentStats = SimpleNeuralGenerationStats();
+    if (m_pTelemetry != nullptr) {
+        auto start = std::chrono::steady_clock::now();
+        m_pTelemetry->write(m_lastStats);
+        this->addPhaseSeconds(SimpleNeuralPhase::IO, secondsSince(start));
+    }
+}
@@ -27,22 +27,75 @@ SOFTWARE.
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <stdint.h>
+
+#include "SimpleNeuralRandom.h"
+#include "SimpleNeuralTelemetry.h"
+
+class SimpleNeuralThreadPool;
+class SimpleNeuralBatchEvaluator;
+class SimpleNeuralDeltaEvaluator;
+class SimpleNeuralGramEvaluator;
+class SimpleNeuralRatingCache;
+class SimpleNeuralRemoteCoordinator;
+struct SimpleNeuralCheckpoint;
+class SimpleNeuralBudget;
+
+enum class SimpleNeuralCrossover {
+    Uniform, // every weight from random parent
+    Layers, // every layer from random parent
+    Neurons // every neuron (row of its input weights) from random parent
+};
+
+// loss of the rating of genom: the mean of the loss of items (or the max for MaxError)
+enum class SimpleNeuralLoss {
+    Euclidean, // sqrt(sum(d^2)) of item (default)
+    MeanSquared, // sum(d^2) / number of outputs
+    MeanAbsolute, // sum(|d|) / number of outputs
+    MaxError // max(|d|) of all items and outputs
+};
 
 class SimpleNeuralNetwork {
     public:
         explicit SimpleNeuralNetwork(std::vector<int> vLayers);
         const std::vector<float> &calc(const std::vector<float> &m_vInput);
+        // calc with external weights (for example a row of the genoms arena), nothing is copied
+        const std::vector<float> &calc(const float *pWeights, const std::vector<float> &vInput);
+        const std::vector<int> &getLayers() const;
         long long getCalcAvarageTimeInNanoseconds();
+        void mergeCalcStatistics(SimpleNeuralNetwork &net);
+        void addCalcStatistics(long long nNanoseconds, int nCalls);
+        void setLoss(SimpleNeuralLoss nLoss);
+        SimpleNeuralLoss getLoss() const;
+        // forward pass and the loss of one item in one pass, without checks, copies and timing;
+        // every neuron sums its inputs in the same order as calc(), so outputs are exactly the same
+        float calcLoss(const float *pWeights, const float *pInput, const float *pExpected);
         const std::vector<float> &getGenom();
+        int getGenomSize() const;
         void setGenom(const std::vector<float> &vWeights);
+        void setRandomSeed(uint64_t nSeed);
         void mutateGenom();
+        void mutateGenom(float *pWeights);
         void mixGenom(const std::vector<float> &vWeights);
+        void mixGenom(const float *pWeights0, const float *pWeights1, float *pOut);
+        // the same with external generator (thread-safe if every thread has own generator);
+        // the light mutation changes weights by 1% or, if nSigma > 0, by the relative N(0, nSigma) step
+        void mutateGenom(float *pWeights, SimpleNeuralRandom &random, float nSigma = 0.0f) const;
+        void mixGenom(
+            const float *pWeights0,
+            const float *pWeights1,
+            float *pOut,
+            SimpleNeuralRandom &random,
+            SimpleNeuralCrossover nCrossover = SimpleNeuralCrossover::Uniform
+        ) const;
 
         void exportToCppFunction(const std::string &sFilename, const std::string &sFuncname, const std::string &sTop = "");
 
     private:
-        float randomWeight();
+        float randomWeight(SimpleNeuralRandom &random) const;
         const std::vector<int> m_vLayers;
+        SimpleNeuralRandom m_random;
         std::vector<float> m_vWeights{};
         std::vector<float> m_vBufferOutput{};
         std::vector<float> m_vBufferSignals{};
@@ -51,6 +104,7 @@ class SimpleNeuralNetwork {
         int m_nInputSize;
         int m_nLayersSize;
         int m_nOutputSize;
+        SimpleNeuralLoss m_nLoss;
 };
 
 class SimpleNeuralTrainingItem {
@@ -72,6 +126,7 @@ class SimpleNeuralTrainingItemList {
         int getNumberOfIn() const;
         int getNumberOfOut() const;
         void addItem(std::vector<float> in, std::vector<float> out);
+        void clear();
         unsigned int size() const;
         std::vector<SimpleNeuralTrainingItem>::iterator begin();
         std::vector<SimpleNeuralTrainingItem>::iterator end();
@@ -83,48 +138,212 @@ class SimpleNeuralTrainingItemList {
 };
 
 
+// Genom owns its weights or is a view to external weights (for example to the row of
+// the SimpleNeuralGenomList arena, nothing is allocated for the views of the list).
+// A copy always owns a copy of weights, so it does not change the original;
+// a move keeps the view (sort() of the list moves only the views)
 class SimpleNeuralGenom {
     public:
         explicit SimpleNeuralGenom(std::vector<float> vGenom, float nRating);
+        SimpleNeuralGenom(float *pWeights, int nSize, float nRating); // the view, weights are not copied
+        SimpleNeuralGenom(const SimpleNeuralGenom &genom);
+        SimpleNeuralGenom(SimpleNeuralGenom &&genom) noexcept;
+        SimpleNeuralGenom &operator=(const SimpleNeuralGenom &genom);
+        SimpleNeuralGenom &operator=(SimpleNeuralGenom &&genom) noexcept;
 
-        const std::vector<float> &getGenom() const;
+        std::vector<float> getGenom() const; // the copy of weights (since the view there is no own vector)
+        const float *getWeights() const;
+        float *getWeights();
+        int getSize() const;
         void setGenom(const std::vector<float> &vGenom);
+        void setGenom(const float *pWeights);
 
         float getRating() const;
         void addRating(float nDiff);
         void setRating(float nRating);
+        // rejected genom has only the lower bound of rating, it's always worse than not rejected
+        bool isRejected() const;
+        void reject(float nLowerBound);
+        bool isBetterThan(const SimpleNeuralGenom &genom) const;
+        // relative step of the light mutation, inherited and mutated with the genom (self-adaptive mutation)
+        float getSigma() const;
+        void setSigma(float nSigma);
 
         void calculateRating(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData);
+        // stops as soon as the rating can not be less or equal nRejectAbove (the genom is rejected),
+        // returns the number of used training items
+        int calculateRatingOrReject(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, float nRejectAbove);
 
     private:
         float m_nRating;
-        std::vector<float> m_vGenom;
+        std::vector<float> m_vOwnWeights; // empty for the view
+        float *m_pWeights;
+        int m_nSize;
+        bool m_bRejected;
+        float m_nSigma;
 };
 
 
 class SimpleNeuralGenomList {
     public:
         SimpleNeuralGenomList(int nBetter, int nMutate, int nMix);
+        ~SimpleNeuralGenomList();
+        void setNumberOfThreads(int nThreads); // 0 - all hardware threads, 1 - serial (default)
+        int getNumberOfThreads() const;
+        double getBusySeconds() const; // sum of working time of all threads (0 in serial mode)
+        // every genom gets own random stream (seed, generation, number of genom),
+        // so the run is reproducible with any number of threads.
+        // If seed is not set, it's taken from std::rand() in fillRandom()
+        void setRandomSeed(uint64_t nSeed);
+        uint64_t getRandomSeed() const;
+        void setCrossover(SimpleNeuralCrossover nCrossover);
+        // the step of the light mutation is stored in every genom: a child takes the step of its parent
+        // multiplied by exp(nTau * N(0, 1)), a mixed child takes the geometric mean of parents' steps
+        void setSelfAdaptiveMutation(bool bEnabled, float nTau = 0.3f);
+        // mini-batch: children are rated on the next nBatchSize training items (shuffled once per epoch),
+        // every nRescoreInterval generations all genoms are rated on the full training data
+        // (only for the rating with SimpleNeuralNetwork, 0 - disabled)
+        void setMiniBatch(int nBatchSize, int nRescoreInterval);
+        // racing: a child is rejected as soon as it can not be better than the worst of better genoms
+        void setRacing(bool bRacing);
+        int getNumberOfRejected() const;
+        float getRacingSavedShare() const; // share of training items skipped in the last rating
+        // pre-screening: children are rated on nProbeSize items of the training data (fixed, evenly spaced),
+        // only the better nShare of them are rated on the full data, the others are rejected with the rating
+        // on the probe (an estimate, not the lower bound). Every nAuditInterval generations the screened out
+        // children are rated on the full data too, to count false rejects: screened out children which
+        // get into better genoms. The audit does not change ratings and the selection, it costs only time
+        // (only for the rating with SimpleNeuralNetwork, 0 - disabled)
+        void setPreScreening(int nProbeSize, float nShare, int nAuditInterval = 10);
+        int getNumberOfScreenedOut() const; // in the last generation
+        float getScreeningFalseRejectRate() const; // share of all audited screened out children
+        // ratings of genoms are remembered, the same genom is not rated again
+        // (only for the rating with SimpleNeuralNetwork on the full training data, 0 - disabled)
+        void setRatingCache(int nCapacity);
+        const SimpleNeuralRatingCache *getRatingCache() const; // nullptr if disabled
         void fillRandom(SimpleNeuralNetwork *pNet);
 
+        // snapshot of the state for resume (see SimpleNeuralCheckpoint)
+        void getCheckpoint(SimpleNeuralCheckpoint &checkpoint) const;
+        void setCheckpoint(const SimpleNeuralCheckpoint &checkpoint, SimpleNeuralNetwork *pNet); // throws if it does not fit the list and the network
+        long long getGeneration() const;
+
+        // wall time of phases, ratings and throughput; a generation ends with calculateRatingForMutatedAndMixed(),
+        // the time of calls between them (sort, mutateAndMix, I/O) goes to the next generation
+        void setTelemetry(SimpleNeuralTelemetryWriter *pWriter); // every finished generation is written, nullptr - disabled
+        const SimpleNeuralGenerationStats &getGenerationStats() const; // of the last finished generation
+        void addPhaseSeconds(SimpleNeuralPhase nPhase, double nSeconds); // for example I/O of the caller
+
+        // the budget is checked before rating of every genom (block of genoms for SimpleNeuralBatchEvaluator),
+        // after its end the rest of genoms are rejected with infinite rating (see SimpleNeuralAnytimeTrainer)
+        void setBudget(const SimpleNeuralBudget *pBudget); // nullptr - no limit
+
         const std::vector<SimpleNeuralGenom> &list() const;
         float getBetterRating();
+        // only the first nBetter genoms are sorted (partial selection), the rest are in any order
         void sort();
         void printFirstRatings(int nNumber);
         void mutateAndMix(SimpleNeuralNetwork *pNet);
 
+        // the rated genom from outside (for example from other population) replaces the worst genom,
+        // returns false if the genom is not better than the worst or it's already in the list
+        bool replaceWorstGenom(const float *pWeights, float nRating);
+
+        // the better genom is tracked on every rating, no sort is needed
         const SimpleNeuralGenom &getBetterGenom();
 
         void calculateRatingForAll(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData);
         void calculateRatingForMutatedAndMixed(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData);
 
+        // the same, but genoms are rated by blocks (see SimpleNeuralBatchEvaluator)
+        void calculateRatingForAll(SimpleNeuralBatchEvaluator *pEvaluator);
+        void calculateRatingForMutatedAndMixed(SimpleNeuralBatchEvaluator *pEvaluator);
+
+        // children are rated by the difference from their parents (see SimpleNeuralDeltaEvaluator)
+        void calculateRatingForMutatedAndMixed(SimpleNeuralDeltaEvaluator *pEvaluator);
+
+        // genoms are rated by the statistics of training data, without a pass over it (see SimpleNeuralGramEvaluator)
+        void calculateRatingForAll(SimpleNeuralGramEvaluator *pEvaluator);
+        void calculateRatingForMutatedAndMixed(SimpleNeuralGramEvaluator *pEvaluator);
+
+        // genoms are rated by worker processes (see SimpleNeuralRemoteCoordinator, not on Windows)
+        void calculateRatingForAll(SimpleNeuralRemoteCoordinator *pCoordinator);
+        void calculateRatingForMutatedAndMixed(SimpleNeuralRemoteCoordinator *pCoordinator);
+
     private:
+        void allocateArena(int nGenomSize);
+        void updateBetterGenom(int nBegin, int nEnd);
+        void prepareWorkerNets(SimpleNeuralNetwork *pNet);
+        void calculateRatingWithRacing(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, int nEnd);
+        int preScreen(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData); // returns the end of promoted children
+        // returns the number of rated genoms, the list is not changed
+        int auditScreening(
+            SimpleNeuralNetwork *pNet,
+            SimpleNeuralTrainingItemList *pFullData,
+            SimpleNeuralTrainingItemList *pSelectionData,
+            int nScreenedOutBegin
+        );
+        void fillMiniBatch(SimpleNeuralTrainingItemList *pTrainingData);
+        void calculateRatingForRange(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, int nBegin, int nEnd);
+        std::vector<int> takeRatingsFromCache(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, int nBegin, int nEnd);
+        void putRatingsToCache(const std::vector<int> &vRated);
+        void calculateRatingForRange(SimpleNeuralBatchEvaluator *pEvaluator, int nBegin, int nEnd);
+        void calculateRatingForRange(SimpleNeuralGramEvaluator *pEvaluator, int nBegin, int nEnd);
+        void finishEvaluation(double nSeconds, int nEvaluations, bool bEndOfGeneration);
+        bool skipWhenBudgetExhausted(SimpleNeuralGenom &genom) const;
+
         int m_nBetterGenoms;
         int m_nMutateGenoms;
         int m_nMixGenoms;
         int m_nAllGenoms;
 
         std::vector<SimpleNeuralGenom> m_vGenoms;
+        uint64_t m_nRandomSeed;
+        bool m_bRandomSeedSet;
+        long long m_nGeneration;
+        SimpleNeuralCrossover m_nCrossover;
+        bool m_bSelfAdaptive;
+        float m_nSelfAdaptiveTau;
+        std::vector<const float *> m_vParents; // parent of every child of the last mutateAndMix()
+        int m_nBetterIndex;
+        bool m_bRacing;
+        long long m_nRacingUsedItems;
+        long long m_nRacingAllItems;
+        int m_nMiniBatchSize;
+        int m_nMiniBatchRescore;
+        std::unique_ptr<SimpleNeuralTrainingItemList> m_pMiniBatch;
+        std::vector<int> m_vMiniBatchOrder;
+        int m_nMiniBatchPosition;
+        long long m_nMiniBatchEpoch;
+        int m_nScreeningProbeSize;
+        float m_nScreeningShare;
+        int m_nScreeningAuditInterval;
+        std::unique_ptr<SimpleNeuralTrainingItemList> m_pProbeData;
+        SimpleNeuralTrainingItemList *m_pProbeSource; // the probe is taken from this training data
+        int m_nScreenedOut;
+        long long m_nScreeningAudited;
+        long long m_nScreeningFalseRejects;
+        std::unique_ptr<SimpleNeuralRatingCache> m_pRatingCache;
+        SimpleNeuralNetwork *m_pRatingCacheNet; // the cached ratings are valid only for this network, data and loss
+        SimpleNeuralTrainingItemList *m_pRatingCacheData;
+        SimpleNeuralLoss m_nRatingCacheLoss;
+        std::vector<uint64_t> m_vHashes; // of genoms to put to the cache
+        const SimpleNeuralBudget *m_pBudget;
+        SimpleNeuralTelemetryWriter *m_pTelemetry;
+        SimpleNeuralGenerationStats m_currentStats;
+        SimpleNeuralGenerationStats m_lastStats;
+        std::vector<float> m_vStatsRatings;
+
+        // all genoms in one block: m_nAllGenoms rows, each row is aligned to 64 bytes;
+        // sort() moves only the views, weights stay on their places
+        std::vector<float> m_vArena;
+        int m_nGenomSize;
+        int m_nArenaStride;
+
+        // one network per worker (worker 0 uses the network of the caller)
+        std::unique_ptr<SimpleNeuralThreadPool> m_pThreadPool;
+        std::vector<SimpleNeuralNetwork> m_vWorkerNets;
+        SimpleNeuralNetwork *m_pWorkerNetsSource;
 };
 
 #endif // __SIMPLE_NEURAL_NETWORK_H__
\ No newline at end of file
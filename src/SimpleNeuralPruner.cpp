@@ -0,0 +1,215 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralPruner.h"
+#include "SimpleNeuralNetwork.h"
+
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralPruner
+
+SimpleNeuralPruner::SimpleNeuralPruner(SimpleNeuralNetwork *pNet) {
+    m_pNet = pNet;
+    m_nRelativeTolerance = 0.05f;
+    m_nAbsoluteTolerance = 0.0f;
+    m_pFineTuningGenoms = nullptr;
+    m_nFineTuningGenerations = 0;
+}
+
+void SimpleNeuralPruner::setTolerance(float nRelative, float nAbsolute) {
+    m_nRelativeTolerance = nRelative;
+    m_nAbsoluteTolerance = nAbsolute;
+}
+
+void SimpleNeuralPruner::setFineTuning(SimpleNeuralGenomList *pGenoms, int nGenerations) {
+    m_pFineTuningGenoms = pGenoms;
+    m_nFineTuningGenerations = nGenerations;
+}
+
+SimpleNeuralPruningResult SimpleNeuralPruner::prune(SimpleNeuralTrainingItemList *pTrainingData) {
+    SimpleNeuralPruningResult result;
+    result.vLayers = m_pNet->getLayers();
+    result.vGenom = m_pNet->getGenom();
+    // own copy: the statistics of calc() of the caller's network are not changed
+    std::unique_ptr<SimpleNeuralNetwork> pNet(new SimpleNeuralNetwork(*m_pNet));
+
+    SimpleNeuralGenom original(result.vGenom.data(), result.vGenom.size(), 0.0f);
+    original.calculateRating(pNet.get(), pTrainingData);
+    result.nOriginalRating = original.getRating();
+    result.nRating = original.getRating();
+    const float nMaxRating = result.nOriginalRating * (1.0f + m_nRelativeTolerance) + m_nAbsoluteTolerance;
+
+    std::vector<float> vCandidate;
+    while (true) {
+        const std::vector<int> &vLayers = result.vLayers;
+        vCandidate = result.vGenom;
+        // without fine-tuning only the removals in the tolerance are interesting
+        const float nRejectAbove = m_pFineTuningGenoms == nullptr ? nMaxRating : std::numeric_limits<float>::infinity();
+        float nBestRating = std::numeric_limits<float>::infinity();
+        int nBestLayer = -1;
+        int nBestNeuron = -1;
+        int nNextOffset = vLayers[0]; // the first weight of the layer nL + 1
+        for (int nL = 1; nL + 1 < vLayers.size(); ++nL) {
+            const int nLayerSize = vLayers[nL];
+            const int nNextLayerSize = vLayers[nL + 1];
+            nNextOffset += vLayers[nL - 1] * nLayerSize;
+            if (nLayerSize == 1) {
+                continue; // the layer keeps one neuron at least
+            }
+            for (int nN = 0; nN < nLayerSize; ++nN) {
+                // the output of the neuron is not used: the same outputs as without the neuron
+                for (int nM = 0; nM < nNextLayerSize; ++nM) {
+                    vCandidate[nNextOffset + nM * nLayerSize + nN] = 0.0f;
+                }
+                SimpleNeuralGenom candidate(vCandidate.data(), vCandidate.size(), 0.0f);
+                candidate.calculateRatingOrReject(pNet.get(), pTrainingData, std::min(nRejectAbove, nBestRating));
+                if (!candidate.isRejected() && candidate.getRating() < nBestRating) {
+                    nBestRating = candidate.getRating();
+                    nBestLayer = nL;
+                    nBestNeuron = nN;
+                }
+                for (int nM = 0; nM < nNextLayerSize; ++nM) {
+                    int nWeight = nNextOffset + nM * nLayerSize + nN;
+                    vCandidate[nWeight] = result.vGenom[nWeight];
+                }
+            }
+        }
+        if (nBestLayer < 0) {
+            break;
+        }
+
+        std::vector<int> vNextLayers;
+        std::vector<float> vNextGenom;
+        SimpleNeuralPruner::removeNeuron(vLayers, result.vGenom, nBestLayer, nBestNeuron, vNextLayers, vNextGenom);
+        std::unique_ptr<SimpleNeuralNetwork> pNextNet(new SimpleNeuralNetwork(vNextLayers));
+        pNextNet->setLoss(m_pNet->getLoss());
+        if (nBestRating > nMaxRating) {
+            nBestRating = this->fineTune(pNextNet.get(), pTrainingData, vNextGenom, nBestRating);
+            if (nBestRating > nMaxRating) {
+                break;
+            }
+            ++result.nFineTunings;
+        }
+        result.vLayers = vNextLayers;
+        result.vGenom = vNextGenom;
+        result.nRating = nBestRating;
+        ++result.nRemovedNeurons;
+        pNet = std::move(pNextNet);
+    }
+
+    // passes of both networks one by one, the fastest of them: the others can be slowed down by the system
+    pNet->setGenom(result.vGenom);
+    SimpleNeuralNetwork originalNet(*m_pNet);
+    result.nOriginalCalcNanoseconds = std::numeric_limits<double>::infinity();
+    result.nCalcNanoseconds = std::numeric_limits<double>::infinity();
+    for (int nPass = 0; nPass < 5; ++nPass) {
+        result.nOriginalCalcNanoseconds = std::min(result.nOriginalCalcNanoseconds, this->measureCalcNanoseconds(&originalNet, pTrainingData));
+        result.nCalcNanoseconds = std::min(result.nCalcNanoseconds, this->measureCalcNanoseconds(pNet.get(), pTrainingData));
+    }
+    if (result.nCalcNanoseconds > 0.0) {
+        result.nCalcSpeedup = result.nOriginalCalcNanoseconds / result.nCalcNanoseconds;
+    }
+    return result;
+}
+
+void SimpleNeuralPruner::removeNeuron(
+    const std::vector<int> &vLayers,
+    const std::vector<float> &vGenom,
+    int nLayer,
+    int nNeuron,
+    std::vector<int> &vOutLayers,
+    std::vector<float> &vOutGenom
+) {
+    if (nLayer < 1 || nLayer + 1 >= vLayers.size()) {
+        throw std::runtime_error("SimpleNeuralPruner: the layer is not hidden");
+    }
+    if (nNeuron < 0 || nNeuron >= vLayers[nLayer] || vLayers[nLayer] == 1) {
+        throw std::runtime_error("SimpleNeuralPruner: the neuron can not be removed");
+    }
+    vOutLayers = vLayers;
+    --vOutLayers[nLayer];
+    vOutGenom.clear();
+    vOutGenom.reserve(vGenom.size());
+    vOutGenom.insert(vOutGenom.end(), vGenom.begin(), vGenom.begin() + vLayers[0]);
+    int nOffset = vLayers[0];
+    for (int nL = 1; nL < vLayers.size(); ++nL) {
+        const int nPrevLayerSize = vLayers[nL - 1];
+        for (int nN = 0; nN < vLayers[nL]; ++nN) {
+            if (nL == nLayer && nN == nNeuron) {
+                continue; // the row of its input weights
+            }
+            for (int nP = 0; nP < nPrevLayerSize; ++nP) {
+                if (nL == nLayer + 1 && nP == nNeuron) {
+                    continue; // its output to the next layer
+                }
+                vOutGenom.push_back(vGenom[nOffset + nN * nPrevLayerSize + nP]);
+            }
+        }
+        nOffset += vLayers[nL] * nPrevLayerSize;
+    }
+    if (nOffset != vGenom.size()) {
+        throw std::runtime_error("SimpleNeuralPruner: the genom does not match the layers");
+    }
+}
+
+float SimpleNeuralPruner::fineTune(
+    SimpleNeuralNetwork *pNet,
+    SimpleNeuralTrainingItemList *pTrainingData,
+    std::vector<float> &vGenom,
+    float nRating
+) {
+    // the population is the reduced genom and its mutations
+    pNet->setGenom(vGenom);
+    m_pFineTuningGenoms->fillRandom(pNet);
+    m_pFineTuningGenoms->calculateRatingForAll(pNet, pTrainingData);
+    m_pFineTuningGenoms->replaceWorstGenom(vGenom.data(), nRating);
+    for (int n = 0; n < m_nFineTuningGenerations; ++n) {
+        m_pFineTuningGenoms->sort();
+        m_pFineTuningGenoms->mutateAndMix(pNet);
+        m_pFineTuningGenoms->calculateRatingForMutatedAndMixed(pNet, pTrainingData);
+    }
+    const SimpleNeuralGenom &better = m_pFineTuningGenoms->getBetterGenom();
+    if (!better.isRejected() && better.getRating() < nRating) {
+        vGenom = better.getGenom();
+        nRating = better.getRating();
+    }
+    return nRating;
+}
+
+double SimpleNeuralPruner::measureCalcNanoseconds(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData) {
+    if (pTrainingData->size() == 0) {
+        return 0.0;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (auto it = pTrainingData->begin(); it != pTrainingData->end(); ++it) {
+        pNet->calc(it->getIn());
+    }
+    auto end = std::chrono::steady_clock::now();
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / pTrainingData->size();
+}
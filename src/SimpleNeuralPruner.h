@@ -0,0 +1,83 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_PRUNER_H__
+#define __SIMPLE_NEURAL_PRUNER_H__
+
+#include <vector>
+
+class SimpleNeuralNetwork;
+class SimpleNeuralTrainingItemList;
+class SimpleNeuralGenomList;
+
+struct SimpleNeuralPruningResult {
+    std::vector<int> vLayers; // the reduced topology
+    std::vector<float> vGenom; // the genom for SimpleNeuralNetwork(vLayers)
+    float nOriginalRating = 0.0f;
+    float nRating = 0.0f;
+    int nRemovedNeurons = 0;
+    int nFineTunings = 0; // removals accepted only after the fine-tuning
+    double nOriginalCalcNanoseconds = 0.0; // of one calc() on the training data
+    double nCalcNanoseconds = 0.0;
+    double nCalcSpeedup = 1.0;
+};
+
+// Removes whole neurons of hidden layers of the trained network one by one: every step removes
+// the neuron without which the rating is the better, until the rating goes out of the tolerance.
+// A neuron is tried by zero weights of its outputs, so the candidates are rated on the same network.
+class SimpleNeuralPruner {
+    public:
+        explicit SimpleNeuralPruner(SimpleNeuralNetwork *pNet);
+        // the rating of the reduced network may be up to
+        // original * (1 + nRelative) + nAbsolute (5% by default)
+        void setTolerance(float nRelative, float nAbsolute = 0.0f);
+        // if the better removal is out of the tolerance, the reduced network is trained
+        // nGenerations by the list and the removal is accepted if it comes back to the tolerance
+        // (nullptr - disabled)
+        void setFineTuning(SimpleNeuralGenomList *pGenoms, int nGenerations);
+
+        SimpleNeuralPruningResult prune(SimpleNeuralTrainingItemList *pTrainingData);
+
+        // the genom of the network without the neuron nNeuron of the hidden layer nLayer
+        static void removeNeuron(
+            const std::vector<int> &vLayers,
+            const std::vector<float> &vGenom,
+            int nLayer,
+            int nNeuron,
+            std::vector<int> &vOutLayers,
+            std::vector<float> &vOutGenom
+        );
+
+    private:
+        float fineTune(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, std::vector<float> &vGenom, float nRating);
+        double measureCalcNanoseconds(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData); // one pass of the data
+
+        SimpleNeuralNetwork *m_pNet;
+        float m_nRelativeTolerance;
+        float m_nAbsoluteTolerance;
+        SimpleNeuralGenomList *m_pFineTuningGenoms;
+        int m_nFineTuningGenerations;
+};
+
+#endif // __SIMPLE_NEURAL_PRUNER_H__
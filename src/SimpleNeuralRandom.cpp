@@ -0,0 +1,115 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralRandom.h"
+
+#include <cmath>
+#include <algorithm>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralRandom
+
+static uint64_t splitmix64(uint64_t &nX) {
+    uint64_t z = (nX += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+SimpleNeuralRandom::SimpleNeuralRandom(uint64_t nSeed, uint64_t nStream) {
+    this->seed(nSeed, nStream);
+}
+
+void SimpleNeuralRandom::seed(uint64_t nSeed, uint64_t nStream) {
+    // mix the stream first, so the close numbers of streams give far states
+    uint64_t nX = nStream;
+    uint64_t nStreamHash = splitmix64(nX);
+    nX = nSeed ^ nStreamHash;
+    for (int i = 0; i < 4; ++i) {
+        m_nState[i] = splitmix64(nX);
+    }
+}
+
+void SimpleNeuralRandom::fill(uint64_t *pOut, int nCount) {
+    constexpr int nLanes = 4;
+    uint64_t s0[nLanes], s1[nLanes], s2[nLanes], s3[nLanes];
+    for (int l = 0; l < nLanes; ++l) {
+        s0[l] = next();
+        s1[l] = next();
+        s2[l] = next();
+        s3[l] = next();
+    }
+    int i = 0;
+    for (; i + nLanes <= nCount; i += nLanes) {
+        for (int l = 0; l < nLanes; ++l) {
+            // x * 5 and x * 9 as shifts, so the loop is vectorized without 64-bit multiplication
+            uint64_t x = s1[l] + (s1[l] << 2);
+            x = (x << 7) | (x >> 57);
+            pOut[i + l] = x + (x << 3);
+            const uint64_t t = s1[l] << 17;
+            s2[l] ^= s0[l];
+            s3[l] ^= s1[l];
+            s1[l] ^= s2[l];
+            s0[l] ^= s3[l];
+            s2[l] ^= t;
+            s3[l] = (s3[l] << 45) | (s3[l] >> 19);
+        }
+    }
+    for (; i < nCount; ++i) {
+        pOut[i] = next();
+    }
+}
+
+void SimpleNeuralRandom::fillGaussian(float *pOut, int nCount) {
+    constexpr int nBlock = 256;
+    constexpr float nTwoPi = 6.28318530718f;
+    uint64_t vRandom[nBlock];
+    for (int nBegin = 0; nBegin < nCount; nBegin += 2 * nBlock) {
+        int nPairs = std::min(nBlock, (nCount - nBegin + 1) / 2);
+        fill(vRandom, nPairs);
+        for (int i = 0; i < nPairs; ++i) {
+            // u1 in (0, 1], so the logarithm is finite
+            float u1 = (float(uint32_t(vRandom[i])) + 1.0f) * (1.0f / 4294967296.0f);
+            float u2 = float(uint32_t(vRandom[i] >> 32)) * (1.0f / 4294967296.0f);
+            float r = std::sqrt(-2.0f * std::log(u1));
+            int n = nBegin + 2 * i;
+            pOut[n] = r * std::cos(nTwoPi * u2);
+            if (n + 1 < nCount) {
+                pOut[n + 1] = r * std::sin(nTwoPi * u2);
+            }
+        }
+    }
+}
+
+void SimpleNeuralRandom::getState(uint64_t *pState) const {
+    for (int i = 0; i < 4; ++i) {
+        pState[i] = m_nState[i];
+    }
+}
+
+void SimpleNeuralRandom::setState(const uint64_t *pState) {
+    for (int i = 0; i < 4; ++i) {
+        m_nState[i] = pState[i];
+    }
+}
@@ -0,0 +1,75 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_RANDOM_H__
+#define __SIMPLE_NEURAL_RANDOM_H__
+
+#include <stdint.h>
+
+// xoshiro256** generator.
+// The state is built by splitmix64 from a pair (seed, stream), so every
+// genom / worker can have its own independent stream derived from one seed
+// of the run. Not thread-safe: one object per thread (or per genom).
+class SimpleNeuralRandom {
+    public:
+        explicit SimpleNeuralRandom(uint64_t nSeed = 0, uint64_t nStream = 0);
+        void seed(uint64_t nSeed, uint64_t nStream = 0);
+
+        uint64_t next();
+        uint32_t nextInt(uint32_t nMax); // [0, nMax)
+        float nextFloat(); // [0, 1)
+        // bulk generation: 4 lanes (seeded from this generator) without dependencies, vectorized
+        void fill(uint64_t *pOut, int nCount);
+        // standard normal values (Box-Muller over the bulk generation)
+        void fillGaussian(float *pOut, int nCount);
+
+        void getState(uint64_t *pState) const; // 4 values
+        void setState(const uint64_t *pState);
+
+    private:
+        uint64_t m_nState[4];
+};
+
+inline uint64_t SimpleNeuralRandom::next() {
+    const uint64_t nResult = ((m_nState[1] * 5) << 7 | (m_nState[1] * 5) >> 57) * 9;
+    const uint64_t t = m_nState[1] << 17;
+    m_nState[2] ^= m_nState[0];
+    m_nState[3] ^= m_nState[1];
+    m_nState[1] ^= m_nState[2];
+    m_nState[0] ^= m_nState[3];
+    m_nState[2] ^= t;
+    m_nState[3] = (m_nState[3] << 45) | (m_nState[3] >> 19);
+    return nResult;
+}
+
+inline uint32_t SimpleNeuralRandom::nextInt(uint32_t nMax) {
+    // multiply-shift (Lemire), bias is negligible for the sizes of genoms
+    return uint32_t(((next() >> 32) * uint64_t(nMax)) >> 32);
+}
+
+inline float SimpleNeuralRandom::nextFloat() {
+    return float(next() >> 40) * (1.0f / 16777216.0f);
+}
+
+#endif // __SIMPLE_NEURAL_RANDOM_H__
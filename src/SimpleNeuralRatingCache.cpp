@@ -0,0 +1,134 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralRatingCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralRatingCache
+
+SimpleNeuralRatingCache::SimpleNeuralRatingCache(int nCapacity) {
+    m_nCapacity = std::max(1, nCapacity);
+    m_nNext = 0;
+    m_nHits = 0;
+    m_nMisses = 0;
+    m_nCollisions = 0;
+    m_vEntries.reserve(m_nCapacity);
+}
+
+uint64_t SimpleNeuralRatingCache::hash(const float *pWeights, int nSize) {
+    // 4 independent lanes of multiply-xor over the bits of weights
+    constexpr uint64_t nPrime0 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t nPrime1 = 0xC2B2AE3D27D4EB4FULL;
+    uint64_t h[4] = {nPrime0, nPrime1, nPrime0 ^ nPrime1, uint64_t(nSize)};
+    int i = 0;
+    for (; i + 4 <= nSize; i += 4) {
+        for (int l = 0; l < 4; ++l) {
+            uint32_t nBits;
+            std::memcpy(&nBits, pWeights + i + l, sizeof(nBits));
+            h[l] = (h[l] ^ nBits) * nPrime1;
+            h[l] ^= h[l] >> 29;
+        }
+    }
+    for (; i < nSize; ++i) {
+        uint32_t nBits;
+        std::memcpy(&nBits, pWeights + i, sizeof(nBits));
+        h[0] = (h[0] ^ nBits) * nPrime1;
+        h[0] ^= h[0] >> 29;
+    }
+    uint64_t nResult = 0;
+    for (int l = 0; l < 4; ++l) {
+        nResult = (nResult ^ h[l]) * nPrime0;
+        nResult ^= nResult >> 32;
+    }
+    return nResult;
+}
+
+bool SimpleNeuralRatingCache::find(uint64_t nHash, const float *pWeights, int nSize, float &nRating) {
+    auto it = m_mapIndex.find(nHash);
+    if (it == m_mapIndex.end()) {
+        ++m_nMisses;
+        return false;
+    }
+    const Entry &entry = m_vEntries[it->second];
+    if (entry.vWeights.size() != nSize || std::memcmp(entry.vWeights.data(), pWeights, nSize * sizeof(float)) != 0) {
+        ++m_nCollisions;
+        ++m_nMisses;
+        return false;
+    }
+    nRating = entry.nRating;
+    ++m_nHits;
+    return true;
+}
+
+void SimpleNeuralRatingCache::insert(uint64_t nHash, const float *pWeights, int nSize, float nRating) {
+    auto it = m_mapIndex.find(nHash);
+    int nIndex;
+    if (it != m_mapIndex.end()) {
+        // the same hash - replace
+        nIndex = it->second;
+    } else if (m_vEntries.size() < m_nCapacity) {
+        nIndex = m_vEntries.size();
+        m_vEntries.emplace_back();
+        m_mapIndex[nHash] = nIndex;
+    } else {
+        nIndex = m_nNext;
+        m_nNext = (m_nNext + 1) % m_nCapacity;
+        m_mapIndex.erase(m_vEntries[nIndex].nHash);
+        m_mapIndex[nHash] = nIndex;
+    }
+    Entry &entry = m_vEntries[nIndex];
+    entry.nHash = nHash;
+    entry.nRating = nRating;
+    entry.vWeights.assign(pWeights, pWeights + nSize);
+}
+
+void SimpleNeuralRatingCache::clear() {
+    m_vEntries.clear();
+    m_mapIndex.clear();
+    m_nNext = 0;
+}
+
+int SimpleNeuralRatingCache::getCapacity() const {
+    return m_nCapacity;
+}
+
+long long SimpleNeuralRatingCache::getHits() const {
+    return m_nHits;
+}
+
+long long SimpleNeuralRatingCache::getMisses() const {
+    return m_nMisses;
+}
+
+long long SimpleNeuralRatingCache::getCollisions() const {
+    return m_nCollisions;
+}
+
+float SimpleNeuralRatingCache::getHitRate() const {
+    long long nAll = m_nHits + m_nMisses;
+    return nAll == 0 ? 0.0f : float(m_nHits) / float(nAll);
+}
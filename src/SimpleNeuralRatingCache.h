@@ -0,0 +1,68 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_RATING_CACHE_H__
+#define __SIMPLE_NEURAL_RATING_CACHE_H__
+
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+
+// Bounded cache of ratings by genom: the same genom (for example a child of
+// crossover of the genom with itself) is not rated twice.
+// Key is 64-bit hash of weights, on the hit the weights are compared exactly.
+// Every entry keeps a copy of the weights: 4 bytes per weight of the genom.
+// When the cache is full, the oldest entry is replaced. Not thread-safe.
+class SimpleNeuralRatingCache {
+    public:
+        explicit SimpleNeuralRatingCache(int nCapacity);
+
+        static uint64_t hash(const float *pWeights, int nSize);
+
+        bool find(uint64_t nHash, const float *pWeights, int nSize, float &nRating);
+        void insert(uint64_t nHash, const float *pWeights, int nSize, float nRating);
+        void clear();
+
+        int getCapacity() const;
+        long long getHits() const;
+        long long getMisses() const;
+        long long getCollisions() const; // the same hash, but other weights
+        float getHitRate() const;
+
+    private:
+        struct Entry {
+            uint64_t nHash;
+            float nRating;
+            std::vector<float> vWeights;
+        };
+        int m_nCapacity;
+        int m_nNext; // the oldest entry
+        std::vector<Entry> m_vEntries;
+        std::unordered_map<uint64_t, int> m_mapIndex;
+        long long m_nHits;
+        long long m_nMisses;
+        long long m_nCollisions;
+};
+
+#endif // __SIMPLE_NEURAL_RATING_CACHE_H__
@@ -0,0 +1,502 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralRemote.h"
+
+#ifndef _WIN32
+
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralBatchEvaluator.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/time.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+namespace {
+
+const uint32_t FRAME_MAGIC = 0x524e4e53; // "SNNR"
+
+enum FrameType : uint32_t {
+    FRAME_RATE = 1,
+    FRAME_RATINGS = 2,
+    FRAME_ERROR = 3,
+    FRAME_STOP = 4
+};
+
+struct FrameHeader {
+    uint32_t nMagic;
+    uint32_t nType;
+    uint32_t nCount;
+    uint32_t nGenomSize;
+};
+
+bool sendAll(int nSocket, const void *pData, size_t nSize) {
+    const char *p = static_cast<const char *>(pData);
+    while (nSize > 0) {
+#ifdef MSG_NOSIGNAL
+        ssize_t nSent = ::send(nSocket, p, nSize, MSG_NOSIGNAL); // no SIGPIPE if the other side is closed
+#else
+        ssize_t nSent = ::send(nSocket, p, nSize, 0);
+#endif
+        if (nSent <= 0) {
+            if (nSent < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += nSent;
+        nSize -= nSent;
+    }
+    return true;
+}
+
+bool recvAll(int nSocket, void *pData, size_t nSize) {
+    char *p = static_cast<char *>(pData);
+    while (nSize > 0) {
+        ssize_t nReceived = ::recv(nSocket, p, nSize, 0);
+        if (nReceived <= 0) {
+            if (nReceived < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += nReceived;
+        nSize -= nReceived;
+    }
+    return true;
+}
+
+bool sendFrame(int nSocket, uint32_t nType, uint32_t nCount, uint32_t nGenomSize, const float *pPayload, size_t nFloats) {
+    FrameHeader header = {FRAME_MAGIC, nType, nCount, nGenomSize};
+    return sendAll(nSocket, &header, sizeof(header))
+        && (nFloats == 0 || sendAll(nSocket, pPayload, nFloats * sizeof(float)));
+}
+
+bool recvHeader(int nSocket, FrameHeader &header) {
+    return recvAll(nSocket, &header, sizeof(header)) && header.nMagic == FRAME_MAGIC;
+}
+
+// "unix:/path" or "tcp:host:port"
+void parseAddress(const std::string &sAddress, std::string &sScheme, std::string &sHost, std::string &sPort) {
+    size_t nColon = sAddress.find(':');
+    if (nColon == std::string::npos) {
+        throw std::runtime_error("SimpleNeuralRemote: wrong address " + sAddress);
+    }
+    sScheme = sAddress.substr(0, nColon);
+    if (sScheme == "unix") {
+        sHost = sAddress.substr(nColon + 1);
+        if (sHost.empty() || sHost.size() >= sizeof(sockaddr_un::sun_path)) {
+            throw std::runtime_error("SimpleNeuralRemote: wrong path of unix socket " + sAddress);
+        }
+        return;
+    }
+    size_t nPortColon = sAddress.rfind(':');
+    if (sScheme != "tcp" || nPortColon == nColon) {
+        throw std::runtime_error("SimpleNeuralRemote: wrong address " + sAddress);
+    }
+    sHost = sAddress.substr(nColon + 1, nPortColon - nColon - 1);
+    sPort = sAddress.substr(nPortColon + 1);
+}
+
+int openSocket(const std::string &sAddress, bool bListen, std::string &sUnixPath) {
+    std::string sScheme, sHost, sPort;
+    parseAddress(sAddress, sScheme, sHost, sPort);
+    if (sScheme == "unix") {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, sHost.c_str(), sizeof(addr.sun_path) - 1);
+        int nSocket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (nSocket < 0) {
+            throw std::runtime_error("SimpleNeuralRemote: could not create socket");
+        }
+        if (bListen) {
+            ::unlink(sHost.c_str());
+            if (::bind(nSocket, (sockaddr *)&addr, sizeof(addr)) != 0 || ::listen(nSocket, 64) != 0) {
+                ::close(nSocket);
+                throw std::runtime_error("SimpleNeuralRemote: could not listen " + sAddress);
+            }
+            sUnixPath = sHost;
+        } else if (::connect(nSocket, (sockaddr *)&addr, sizeof(addr)) != 0) {
+            ::close(nSocket);
+            throw std::runtime_error("SimpleNeuralRemote: could not connect to " + sAddress);
+        }
+        return nSocket;
+    }
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = bListen ? AI_PASSIVE : 0;
+    addrinfo *pInfo = nullptr;
+    if (::getaddrinfo(sHost.empty() ? nullptr : sHost.c_str(), sPort.c_str(), &hints, &pInfo) != 0) {
+        throw std::runtime_error("SimpleNeuralRemote: could not resolve " + sAddress);
+    }
+    int nSocket = -1;
+    for (addrinfo *p = pInfo; p != nullptr && nSocket < 0; p = p->ai_next) {
+        nSocket = ::socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+        if (nSocket < 0) {
+            continue;
+        }
+        int nOne = 1;
+        bool bOk;
+        if (bListen) {
+            ::setsockopt(nSocket, SOL_SOCKET, SO_REUSEADDR, &nOne, sizeof(nOne));
+            bOk = ::bind(nSocket, p->ai_addr, p->ai_addrlen) == 0 && ::listen(nSocket, 64) == 0;
+        } else {
+            bOk = ::connect(nSocket, p->ai_addr, p->ai_addrlen) == 0;
+            // frames are small, send them at once
+            ::setsockopt(nSocket, IPPROTO_TCP, TCP_NODELAY, &nOne, sizeof(nOne));
+        }
+        if (!bOk) {
+            ::close(nSocket);
+            nSocket = -1;
+        }
+    }
+    ::freeaddrinfo(pInfo);
+    if (nSocket < 0) {
+        throw std::runtime_error("SimpleNeuralRemote: could not " + std::string(bListen ? "listen " : "connect to ") + sAddress);
+    }
+    return nSocket;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------
+// SimpleNeuralRemoteCoordinator
+
+SimpleNeuralRemoteCoordinator::SimpleNeuralRemoteCoordinator() {
+    m_nListenSocket = -1;
+    m_nDroppedWorkers = 0;
+    m_nChunkSize = 0;
+    m_nTimeoutMs = 30000;
+    m_pGenoms = nullptr;
+    m_nCount = 0;
+    m_nChunk = 0;
+    m_nGenomSize = 0;
+}
+
+SimpleNeuralRemoteCoordinator::~SimpleNeuralRemoteCoordinator() {
+    this->stopWorkers();
+    if (m_nListenSocket >= 0) {
+        ::close(m_nListenSocket);
+    }
+    if (!m_sUnixPath.empty()) {
+        ::unlink(m_sUnixPath.c_str());
+    }
+}
+
+void SimpleNeuralRemoteCoordinator::listen(const std::string &sAddress) {
+    if (m_nListenSocket >= 0) {
+        throw std::runtime_error("SimpleNeuralRemoteCoordinator: already listening");
+    }
+    m_nListenSocket = openSocket(sAddress, true, m_sUnixPath);
+}
+
+int SimpleNeuralRemoteCoordinator::acceptWorkers(int nWorkers, int nTimeoutMs) {
+    if (m_nListenSocket < 0) {
+        throw std::runtime_error("SimpleNeuralRemoteCoordinator: listen() was not called");
+    }
+    int nAccepted = 0;
+    while (nAccepted < nWorkers) {
+        pollfd fd = {m_nListenSocket, POLLIN, 0};
+        int nReady = ::poll(&fd, 1, nTimeoutMs);
+        if (nReady < 0 && errno == EINTR) {
+            continue;
+        }
+        if (nReady <= 0) {
+            break; // timeout
+        }
+        int nSocket = ::accept(m_nListenSocket, nullptr, nullptr);
+        if (nSocket >= 0) {
+            this->addWorker(nSocket);
+            ++nAccepted;
+        }
+    }
+    return nAccepted;
+}
+
+void SimpleNeuralRemoteCoordinator::addWorker(int nSocket) {
+    Worker worker;
+    worker.nSocket = nSocket;
+    worker.tWaitSince = std::chrono::steady_clock::now();
+    this->applyTimeout(nSocket);
+    m_vWorkers.push_back(worker);
+}
+
+int SimpleNeuralRemoteCoordinator::getNumberOfWorkers() const {
+    return m_vWorkers.size();
+}
+
+int SimpleNeuralRemoteCoordinator::getNumberOfDroppedWorkers() const {
+    return m_nDroppedWorkers;
+}
+
+void SimpleNeuralRemoteCoordinator::setChunkSize(int nGenoms) {
+    m_nChunkSize = std::max(0, nGenoms);
+}
+
+void SimpleNeuralRemoteCoordinator::setTimeout(int nTimeoutMs) {
+    m_nTimeoutMs = nTimeoutMs < 0 ? -1 : nTimeoutMs;
+    for (int w = 0; w < m_vWorkers.size(); ++w) {
+        this->applyTimeout(m_vWorkers[w].nSocket);
+    }
+}
+
+void SimpleNeuralRemoteCoordinator::calculateRating(SimpleNeuralGenom *pGenoms, int nCount) {
+    if (nCount <= 0) {
+        return;
+    }
+    if (m_vWorkers.empty()) {
+        throw std::runtime_error("SimpleNeuralRemoteCoordinator: no workers");
+    }
+    m_pGenoms = pGenoms;
+    m_nCount = nCount;
+    m_nGenomSize = pGenoms[0].getSize();
+    // a few frames per worker, so the fast workers take more of them
+    m_nChunk = m_nChunkSize > 0 ? m_nChunkSize : std::max<int>(1, (nCount + 4 * m_vWorkers.size() - 1) / (4 * m_vWorkers.size()));
+    int nChunks = (nCount + m_nChunk - 1) / m_nChunk;
+    std::deque<int> vQueue;
+    for (int i = 0; i < nChunks; ++i) {
+        vQueue.push_back(i);
+    }
+
+    int nDone = 0;
+    std::vector<pollfd> vPoll;
+    std::vector<float> vRatings;
+    while (nDone < nChunks) {
+        // keep every worker busy
+        for (int w = 0; w < m_vWorkers.size(); ++w) {
+            while (m_vWorkers[w].vInFlight.size() < 2 && !vQueue.empty()) {
+                int nChunk = vQueue.front();
+                vQueue.pop_front();
+                if (m_vWorkers[w].vInFlight.empty()) {
+                    m_vWorkers[w].tWaitSince = std::chrono::steady_clock::now();
+                }
+                m_vWorkers[w].vInFlight.push_back(nChunk);
+                if (!this->sendChunk(m_vWorkers[w], nChunk)) {
+                    this->dropWorker(w, vQueue);
+                    --w;
+                    break;
+                }
+            }
+        }
+        if (m_vWorkers.empty()) {
+            throw std::runtime_error("SimpleNeuralRemoteCoordinator: all workers are dropped");
+        }
+
+        // wait up to the nearest timeout of a busy worker
+        auto tNow = std::chrono::steady_clock::now();
+        int nPollMs = -1;
+        vPoll.clear();
+        for (int w = 0; w < m_vWorkers.size(); ++w) {
+            vPoll.push_back({m_vWorkers[w].nSocket, POLLIN, 0});
+            if (m_nTimeoutMs >= 0 && !m_vWorkers[w].vInFlight.empty()) {
+                long long nLeftMs = m_nTimeoutMs
+                    - std::chrono::duration_cast<std::chrono::milliseconds>(tNow - m_vWorkers[w].tWaitSince).count();
+                int nWorkerMs = (int)std::max(0LL, nLeftMs);
+                nPollMs = nPollMs < 0 ? nWorkerMs : std::min(nPollMs, nWorkerMs);
+            }
+        }
+        int nReady = ::poll(vPoll.data(), vPoll.size(), nPollMs);
+        if (nReady < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("SimpleNeuralRemoteCoordinator: poll failed");
+        }
+        // backwards: a dropped worker is removed from the list
+        for (int w = vPoll.size() - 1; w >= 0; --w) {
+            if (vPoll[w].revents == 0) {
+                continue;
+            }
+            Worker &worker = m_vWorkers[w];
+            FrameHeader header;
+            if (worker.vInFlight.empty() || !recvHeader(worker.nSocket, header)) {
+                this->dropWorker(w, vQueue);
+                continue;
+            }
+            if (header.nType == FRAME_ERROR) {
+                // the worker can not rate these genoms, others can
+                this->dropWorker(w, vQueue);
+                continue;
+            }
+            int nFirst = worker.vInFlight.front() * m_nChunk;
+            int nSize = std::min(m_nChunk, m_nCount - nFirst);
+            vRatings.resize(nSize);
+            if (header.nType != FRAME_RATINGS || header.nCount != nSize
+                || !recvAll(worker.nSocket, vRatings.data(), nSize * sizeof(float))
+            ) {
+                this->dropWorker(w, vQueue);
+                continue;
+            }
+            for (int i = 0; i < nSize; ++i) {
+                m_pGenoms[nFirst + i].setRating(vRatings[i]);
+            }
+            worker.vInFlight.pop_front();
+            worker.tWaitSince = std::chrono::steady_clock::now();
+            ++nDone;
+        }
+        // a stalled worker is dropped, its frames go to others
+        if (m_nTimeoutMs >= 0) {
+            tNow = std::chrono::steady_clock::now();
+            for (int w = m_vWorkers.size() - 1; w >= 0; --w) {
+                if (!m_vWorkers[w].vInFlight.empty()
+                    && tNow - m_vWorkers[w].tWaitSince >= std::chrono::milliseconds(m_nTimeoutMs)
+                ) {
+                    this->dropWorker(w, vQueue);
+                }
+            }
+        }
+    }
+    m_pGenoms = nullptr;
+}
+
+void SimpleNeuralRemoteCoordinator::stopWorkers() {
+    for (int w = 0; w < m_vWorkers.size(); ++w) {
+        sendFrame(m_vWorkers[w].nSocket, FRAME_STOP, 0, 0, nullptr, 0);
+        ::close(m_vWorkers[w].nSocket);
+    }
+    m_vWorkers.clear();
+}
+
+bool SimpleNeuralRemoteCoordinator::sendChunk(Worker &worker, int nChunk) {
+    int nFirst = nChunk * m_nChunk;
+    int nSize = std::min(m_nChunk, m_nCount - nFirst);
+    m_vFrame.resize((size_t)nSize * m_nGenomSize);
+    for (int i = 0; i < nSize; ++i) {
+        std::memcpy(m_vFrame.data() + (size_t)i * m_nGenomSize, m_pGenoms[nFirst + i].getWeights(), m_nGenomSize * sizeof(float));
+    }
+    return sendFrame(worker.nSocket, FRAME_RATE, nSize, m_nGenomSize, m_vFrame.data(), m_vFrame.size());
+}
+
+void SimpleNeuralRemoteCoordinator::dropWorker(int nWorker, std::deque<int> &vQueue) {
+    // frames of the worker go to others
+    Worker &worker = m_vWorkers[nWorker];
+    for (int i = worker.vInFlight.size() - 1; i >= 0; --i) {
+        vQueue.push_front(worker.vInFlight[i]);
+    }
+    ::close(worker.nSocket);
+    m_vWorkers.erase(m_vWorkers.begin() + nWorker);
+    ++m_nDroppedWorkers;
+}
+
+void SimpleNeuralRemoteCoordinator::applyTimeout(int nSocket) {
+    // a worker stalled in the middle of a frame does not block send/recv forever
+    timeval tv;
+    tv.tv_sec = m_nTimeoutMs < 0 ? 0 : m_nTimeoutMs / 1000;
+    tv.tv_usec = m_nTimeoutMs < 0 ? 0 : (m_nTimeoutMs % 1000) * 1000;
+    ::setsockopt(nSocket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(nSocket, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+// ---------------------------------------------------------------------
+// SimpleNeuralRemoteWorker
+
+SimpleNeuralRemoteWorker::SimpleNeuralRemoteWorker(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData) {
+    m_pEvaluator.reset(new SimpleNeuralBatchEvaluator(pNet, pTrainingData));
+    m_nGenomSize = pNet->getGenomSize();
+    m_nMaxFrameGenoms = 65536;
+    m_nSocket = -1;
+}
+
+SimpleNeuralRemoteWorker::~SimpleNeuralRemoteWorker() {
+    if (m_nSocket >= 0) {
+        ::close(m_nSocket);
+    }
+}
+
+void SimpleNeuralRemoteWorker::connect(const std::string &sAddress) {
+    if (m_nSocket >= 0) {
+        ::close(m_nSocket);
+    }
+    m_nSocket = SimpleNeuralRemoteWorker::connectSocket(sAddress);
+}
+
+void SimpleNeuralRemoteWorker::attach(int nSocket) {
+    if (m_nSocket >= 0) {
+        ::close(m_nSocket);
+    }
+    m_nSocket = nSocket;
+}
+
+void SimpleNeuralRemoteWorker::setMaxFrameGenoms(int nGenoms) {
+    m_nMaxFrameGenoms = std::max(1, nGenoms);
+}
+
+long long SimpleNeuralRemoteWorker::serve() {
+    if (m_nSocket < 0) {
+        throw std::runtime_error("SimpleNeuralRemoteWorker: connect() was not called");
+    }
+    long long nRated = 0;
+    std::vector<float> vWeights;
+    std::vector<float> vRatings;
+    std::vector<SimpleNeuralGenom> vGenoms;
+    FrameHeader header;
+    while (recvHeader(m_nSocket, header) && header.nType == FRAME_RATE) {
+        // the size is checked before allocation, a wrong frame can not take the memory
+        if (header.nGenomSize != m_nGenomSize || header.nCount > (uint32_t)m_nMaxFrameGenoms) {
+            // the payload is not read, so the connection can not be used after it
+            sendFrame(m_nSocket, FRAME_ERROR, 0, 0, nullptr, 0);
+            break;
+        }
+        vWeights.resize((size_t)header.nCount * m_nGenomSize);
+        if (!recvAll(m_nSocket, vWeights.data(), vWeights.size() * sizeof(float))) {
+            break;
+        }
+        vGenoms.clear();
+        for (int i = 0; i < header.nCount; ++i) {
+            vGenoms.emplace_back(vWeights.data() + (size_t)i * m_nGenomSize, m_nGenomSize, 0.0f);
+        }
+        m_pEvaluator->calculateRating(vGenoms.data(), vGenoms.size());
+        vRatings.resize(header.nCount);
+        for (int i = 0; i < header.nCount; ++i) {
+            vRatings[i] = vGenoms[i].getRating();
+        }
+        if (!sendFrame(m_nSocket, FRAME_RATINGS, header.nCount, 0, vRatings.data(), vRatings.size())) {
+            break;
+        }
+        nRated += header.nCount;
+    }
+    ::close(m_nSocket);
+    m_nSocket = -1;
+    return nRated;
+}
+
+int SimpleNeuralRemoteWorker::connectSocket(const std::string &sAddress) {
+    std::string sUnixPath;
+    return openSocket(sAddress, false, sUnixPath);
+}
+
+#endif // _WIN32
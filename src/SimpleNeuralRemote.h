@@ -0,0 +1,124 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_REMOTE_H__
+#define __SIMPLE_NEURAL_REMOTE_H__
+
+#ifndef _WIN32
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <stdint.h>
+
+class SimpleNeuralNetwork;
+class SimpleNeuralTrainingItemList;
+class SimpleNeuralGenom;
+class SimpleNeuralBatchEvaluator;
+
+// Rating of genoms in other processes (or on other hosts with the same byte order).
+// Workers load training data once, the coordinator sends them genoms
+// and receives ratings in binary frames over sockets.
+// Address: "unix:/path/to/socket" or "tcp:host:port".
+//
+// Frame: header (magic, type, count, genom size - uint32 each) and payload:
+//   rate    - count * genom size floats (coordinator -> worker)
+//   ratings - count floats (worker -> coordinator)
+//   error   - no payload, worker can not rate genoms of this size or so many of them
+//             and closes the connection
+//   stop    - no payload, worker leaves serve()
+
+class SimpleNeuralRemoteCoordinator {
+    public:
+        SimpleNeuralRemoteCoordinator();
+        ~SimpleNeuralRemoteCoordinator(); // stops workers
+
+        void listen(const std::string &sAddress);
+        // waits for workers up to nTimeoutMs (-1 - no limit), returns the number of accepted workers
+        int acceptWorkers(int nWorkers, int nTimeoutMs = -1);
+        void addWorker(int nSocket); // already connected socket, the coordinator owns it
+        int getNumberOfWorkers() const; // alive
+        int getNumberOfDroppedWorkers() const;
+        void setChunkSize(int nGenoms); // genoms per frame, 0 - by the number of workers (default)
+        // a worker without an answer for nTimeoutMs is dropped (-1 - no limit), default 30 s
+        void setTimeout(int nTimeoutMs);
+
+        // every worker has up to 2 frames in progress, so it does not wait for the next one;
+        // frames of a dropped worker (closed, stalled or answered with error) are sent to others.
+        // Throws if all workers are dropped
+        void calculateRating(SimpleNeuralGenom *pGenoms, int nCount);
+        void stopWorkers();
+
+    private:
+        struct Worker {
+            int nSocket;
+            std::deque<int> vInFlight; // numbers of chunks
+            std::chrono::steady_clock::time_point tWaitSince; // the last answer or the first frame in flight
+        };
+        bool sendChunk(Worker &worker, int nChunk);
+        void dropWorker(int nWorker, std::deque<int> &vQueue);
+        void applyTimeout(int nSocket);
+
+        std::vector<Worker> m_vWorkers;
+        int m_nListenSocket;
+        std::string m_sUnixPath;
+        int m_nDroppedWorkers;
+        int m_nChunkSize;
+        int m_nTimeoutMs;
+
+        // the current job
+        SimpleNeuralGenom *m_pGenoms;
+        int m_nCount;
+        int m_nChunk;
+        int m_nGenomSize;
+        std::vector<float> m_vFrame;
+};
+
+class SimpleNeuralRemoteWorker {
+    public:
+        SimpleNeuralRemoteWorker(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData);
+        ~SimpleNeuralRemoteWorker();
+
+        void connect(const std::string &sAddress);
+        void attach(int nSocket); // already connected socket, the worker owns it
+        // genoms per frame at most, a larger frame is answered with error without allocation, default 65536
+        void setMaxFrameGenoms(int nGenoms);
+        // rates genoms until the coordinator stops the worker or closes the connection,
+        // returns the number of rated genoms
+        long long serve();
+
+        static int connectSocket(const std::string &sAddress);
+
+    private:
+        std::unique_ptr<SimpleNeuralBatchEvaluator> m_pEvaluator;
+        int m_nGenomSize;
+        int m_nMaxFrameGenoms;
+        int m_nSocket;
+};
+
+#endif // _WIN32
+
+#endif // __SIMPLE_NEURAL_REMOTE_H__
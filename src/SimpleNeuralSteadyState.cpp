@@ -0,0 +1,331 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralSteadyState.h"
+#include "SimpleNeuralThreadPool.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralSteadyState
+
+SimpleNeuralSteadyState::SimpleNeuralSteadyState(int nElite) {
+    if (nElite < 1) {
+        throw std::runtime_error("SimpleNeuralSteadyState: expected at least one elite genom");
+    }
+    m_nElite = nElite;
+    m_nGenomSize = 0;
+    m_nWorstIndex = 0;
+    m_nBetterIndex = 0;
+    m_nRandomSeed = std::rand();
+    m_nCrossover = SimpleNeuralCrossover::Uniform;
+    m_nMutateShare = 0.5f;
+    m_nChildren = 0;
+    m_nRated = 0;
+    m_nAccepted = 0;
+    m_pRunningData = nullptr;
+    m_bStop = false;
+    m_bRunnerDone = true;
+    m_pWorkerNetsSource = nullptr;
+    this->setNumberOfThreads(0);
+}
+
+SimpleNeuralSteadyState::~SimpleNeuralSteadyState() {
+    // defined here, where SimpleNeuralThreadPool is a complete type
+    if (m_runner.joinable()) {
+        // the error of a worker can not be thrown from the destructor,
+        // statistics are not merged: the net of start() can be destroyed already
+        this->joinRunner();
+    }
+}
+
+void SimpleNeuralSteadyState::setNumberOfThreads(int nThreads) {
+    this->stop();
+    if (nThreads < 1) {
+        nThreads = SimpleNeuralThreadPool::getDefaultNumberOfThreads();
+    }
+    m_pThreadPool.reset(new SimpleNeuralThreadPool(nThreads));
+    m_pWorkerNetsSource = nullptr;
+}
+
+int SimpleNeuralSteadyState::getNumberOfThreads() const {
+    return m_pThreadPool->getNumberOfThreads();
+}
+
+void SimpleNeuralSteadyState::setRandomSeed(uint64_t nSeed) {
+    this->stop();
+    m_nRandomSeed = nSeed;
+}
+
+void SimpleNeuralSteadyState::setCrossover(SimpleNeuralCrossover nCrossover) {
+    this->stop();
+    m_nCrossover = nCrossover;
+}
+
+void SimpleNeuralSteadyState::setMutateShare(float nShare) {
+    this->stop();
+    m_nMutateShare = std::min(1.0f, std::max(0.0f, nShare));
+}
+
+void SimpleNeuralSteadyState::fillRandom(SimpleNeuralNetwork *pNet) {
+    // the same start as in SimpleNeuralGenomList: every next genom is the previous one with one more mutation
+    this->stop();
+    m_nGenomSize = pNet->getGenomSize();
+    m_vWeights.resize((size_t)m_nElite * m_nGenomSize);
+    m_vRatings.assign(m_nElite, 100000.0f);
+    const float *pPrev = pNet->getGenom().data();
+    for (int i = 0; i < m_nElite; ++i) {
+        float *pWeights = m_vWeights.data() + (size_t)i * m_nGenomSize;
+        std::memcpy(pWeights, pPrev, m_nGenomSize * sizeof(float));
+        SimpleNeuralRandom random(m_nRandomSeed, i);
+        pNet->mutateGenom(pWeights, random);
+        pPrev = pWeights;
+    }
+    m_nChildren = 0;
+    m_nRated = 0;
+    m_nAccepted = 0;
+    this->updateWorstAndBetter();
+}
+
+void SimpleNeuralSteadyState::calculateRatingForAll(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData) {
+    this->stop();
+    this->prepareWorkers(pNet);
+    m_pThreadPool->parallelFor(0, m_nElite, [&](int nWorker, int nIndex) {
+        SimpleNeuralGenom genom(m_vWeights.data() + (size_t)nIndex * m_nGenomSize, m_nGenomSize, 0.0f);
+        genom.calculateRating(&m_vWorkerNets[nWorker], pTrainingData);
+        m_vRatings[nIndex] = genom.getRating();
+    });
+    for (int i = 0; i < m_vWorkerNets.size(); ++i) {
+        pNet->mergeCalcStatistics(m_vWorkerNets[i]);
+    }
+    this->updateWorstAndBetter();
+}
+
+void SimpleNeuralSteadyState::evolve(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, int nChildren) {
+    if (m_pThreadPool->getNumberOfThreads() == 1) {
+        // on the calling thread, the same children in every run
+        this->stop();
+        this->prepareWorkers(pNet);
+        for (int i = 0; i < nChildren; ++i) {
+            this->produceChild(&m_vWorkerNets[0], pTrainingData, 0);
+            this->countRatedChild();
+        }
+        pNet->mergeCalcStatistics(m_vWorkerNets[0]);
+        return;
+    }
+    long long nTarget = m_nRated + nChildren;
+    this->start(pNet, pTrainingData);
+    this->waitForChildren(nTarget);
+}
+
+void SimpleNeuralSteadyState::start(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData) {
+    if (this->isRunning() && m_pWorkerNetsSource == pNet && m_pRunningData == pTrainingData) {
+        return;
+    }
+    this->stop(); // the run with other net or data, or the finished run
+    this->prepareWorkers(pNet);
+    m_pRunningData = pTrainingData;
+    m_bStop = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mtxRated);
+        m_bRunnerDone = false;
+    }
+    int nThreads = m_pThreadPool->getNumberOfThreads();
+    m_runner = std::thread([this, nThreads]() {
+        std::exception_ptr pException;
+        try {
+            // one endless task per worker: a worker takes the next child as soon as its child is inserted
+            m_pThreadPool->parallelFor(0, nThreads, [this](int nWorker, int /* nTask */) {
+                try {
+                    while (!m_bStop) {
+                        this->produceChild(&m_vWorkerNets[nWorker], m_pRunningData, nWorker);
+                        this->countRatedChild();
+                    }
+                } catch (...) {
+                    m_bStop = true; // others leave too, so parallelFor returns
+                    throw;
+                }
+            });
+        } catch (...) {
+            pException = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mtxRated);
+            m_pRunnerException = pException;
+            m_bRunnerDone = true;
+        }
+        m_cvRated.notify_all();
+    });
+}
+
+void SimpleNeuralSteadyState::waitForChildren(long long nChildren) {
+    bool bFailed;
+    {
+        std::unique_lock<std::mutex> lock(m_mtxRated);
+        m_cvRated.wait(lock, [&]() { return m_nRated >= nChildren || m_bRunnerDone; });
+        bFailed = m_pRunnerException != nullptr;
+    }
+    if (bFailed) {
+        this->stop(); // rethrows the error of the worker
+    }
+}
+
+void SimpleNeuralSteadyState::stop() {
+    if (!m_runner.joinable()) {
+        return;
+    }
+    std::exception_ptr pException = this->joinRunner();
+    for (int i = 0; i < m_vWorkerNets.size(); ++i) {
+        m_pWorkerNetsSource->mergeCalcStatistics(m_vWorkerNets[i]);
+    }
+    m_pWorkerNetsSource = nullptr; // merged, the next run copies the net again
+    if (pException) {
+        std::rethrow_exception(pException);
+    }
+}
+
+std::exception_ptr SimpleNeuralSteadyState::joinRunner() {
+    m_bStop = true;
+    m_runner.join();
+    std::lock_guard<std::mutex> lock(m_mtxRated);
+    std::exception_ptr pException = m_pRunnerException;
+    m_pRunnerException = nullptr;
+    return pException;
+}
+
+bool SimpleNeuralSteadyState::isRunning() const {
+    std::lock_guard<std::mutex> lock(m_mtxRated);
+    return m_runner.joinable() && !m_bRunnerDone;
+}
+
+long long SimpleNeuralSteadyState::getNumberOfChildren() const {
+    return m_nRated;
+}
+
+long long SimpleNeuralSteadyState::getNumberOfAccepted() const {
+    return m_nAccepted;
+}
+
+double SimpleNeuralSteadyState::getBusySeconds() const {
+    return m_pThreadPool->getBusySeconds();
+}
+
+float SimpleNeuralSteadyState::getBetterRating() {
+    std::shared_lock<std::shared_timed_mutex> lock(m_mtxElite);
+    return m_vRatings[m_nBetterIndex];
+}
+
+std::vector<float> SimpleNeuralSteadyState::getBetterGenom() {
+    std::shared_lock<std::shared_timed_mutex> lock(m_mtxElite);
+    const float *pWeights = m_vWeights.data() + (size_t)m_nBetterIndex * m_nGenomSize;
+    return std::vector<float>(pWeights, pWeights + m_nGenomSize);
+}
+
+void SimpleNeuralSteadyState::prepareWorkers(SimpleNeuralNetwork *pNet) {
+    int nThreads = m_pThreadPool->getNumberOfThreads();
+    if (m_pWorkerNetsSource != pNet || m_vWorkerNets.size() != nThreads) {
+        m_vWorkerNets.clear();
+        m_vWorkerNets.reserve(nThreads);
+        for (int i = 0; i < nThreads; ++i) {
+            m_vWorkerNets.emplace_back(*pNet);
+        }
+        m_pWorkerNetsSource = pNet;
+    }
+    // the loss can be changed after the copy
+    for (int i = 0; i < m_vWorkerNets.size(); ++i) {
+        m_vWorkerNets[i].setLoss(pNet->getLoss());
+    }
+    m_vWorkers.resize(nThreads);
+    for (int i = 0; i < nThreads; ++i) {
+        m_vWorkers[i].vParent0.resize(m_nGenomSize);
+        m_vWorkers[i].vParent1.resize(m_nGenomSize);
+        m_vWorkers[i].vChild.resize(m_nGenomSize);
+    }
+}
+
+void SimpleNeuralSteadyState::produceChild(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, int nWorker) {
+    Worker &worker = m_vWorkers[nWorker];
+    long long nChild = m_nChildren++;
+    SimpleNeuralRandom random(m_nRandomSeed, (uint64_t(1) << 62) | uint64_t(nChild));
+    bool bMutate = random.nextFloat() < m_nMutateShare;
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(m_mtxElite);
+        int n0 = random.nextInt(m_nElite);
+        std::memcpy(worker.vParent0.data(), m_vWeights.data() + (size_t)n0 * m_nGenomSize, m_nGenomSize * sizeof(float));
+        if (!bMutate) {
+            int n1 = random.nextInt(m_nElite);
+            std::memcpy(worker.vParent1.data(), m_vWeights.data() + (size_t)n1 * m_nGenomSize, m_nGenomSize * sizeof(float));
+        }
+    }
+    if (bMutate) {
+        worker.vChild = worker.vParent0;
+        pNet->mutateGenom(worker.vChild.data(), random);
+    } else {
+        pNet->mixGenom(worker.vParent0.data(), worker.vParent1.data(), worker.vChild.data(), random, m_nCrossover);
+    }
+    SimpleNeuralGenom child(worker.vChild.data(), m_nGenomSize, 0.0f);
+    child.calculateRating(pNet, pTrainingData);
+    float nRating = child.getRating();
+
+    std::unique_lock<std::shared_timed_mutex> lock(m_mtxElite);
+    if (!(nRating < m_vRatings[m_nWorstIndex])) {
+        return;
+    }
+    for (int i = 0; i < m_nElite; ++i) {
+        if (m_vRatings[i] == nRating
+            && std::memcmp(m_vWeights.data() + (size_t)i * m_nGenomSize, worker.vChild.data(), m_nGenomSize * sizeof(float)) == 0
+        ) {
+            return; // copy of the elite genom
+        }
+    }
+    std::memcpy(m_vWeights.data() + (size_t)m_nWorstIndex * m_nGenomSize, worker.vChild.data(), m_nGenomSize * sizeof(float));
+    m_vRatings[m_nWorstIndex] = nRating;
+    ++m_nAccepted;
+    this->updateWorstAndBetter();
+}
+
+void SimpleNeuralSteadyState::countRatedChild() {
+    {
+        std::lock_guard<std::mutex> lock(m_mtxRated);
+        ++m_nRated;
+    }
+    m_cvRated.notify_all();
+}
+
+void SimpleNeuralSteadyState::updateWorstAndBetter() {
+    m_nWorstIndex = 0;
+    m_nBetterIndex = 0;
+    for (int i = 1; i < m_nElite; ++i) {
+        if (m_vRatings[i] > m_vRatings[m_nWorstIndex]) {
+            m_nWorstIndex = i;
+        }
+        if (m_vRatings[i] < m_vRatings[m_nBetterIndex]) {
+            m_nBetterIndex = i;
+        }
+    }
+}
@@ -0,0 +1,122 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_STEADY_STATE_H__
+#define __SIMPLE_NEURAL_STEADY_STATE_H__
+
+#include "SimpleNeuralNetwork.h"
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <shared_mutex>
+#include <stdint.h>
+
+class SimpleNeuralThreadPool;
+
+// Steady-state genetic algorithm: no generations and no barriers between them.
+// Every worker takes parents from the elite pool, produces a child, rates it
+// and puts it into the pool at once, if the child is better than the worst elite genom.
+// Parents are read under the shared lock, only the insert of a child is exclusive.
+// With more than one thread the workers run in the background from start() (or the first evolve())
+// to stop(), also between calls of evolve(), and the result depends on the timing of workers.
+// With one thread evolve() produces children on the calling thread and the run is reproducible.
+class SimpleNeuralSteadyState {
+    public:
+        explicit SimpleNeuralSteadyState(int nElite);
+        ~SimpleNeuralSteadyState(); // stops workers, statistics of calculations are not merged
+        void setNumberOfThreads(int nThreads); // 0 - all hardware threads (default), 1 - serial
+        int getNumberOfThreads() const;
+        void setRandomSeed(uint64_t nSeed);
+        void setCrossover(SimpleNeuralCrossover nCrossover);
+        void setMutateShare(float nShare); // share of children by mutation, the rest by crossover (0.5 by default)
+
+        // setters above and below stop workers
+        void fillRandom(SimpleNeuralNetwork *pNet);
+        void calculateRatingForAll(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData);
+        // waits for nChildren more rated children, the workers are not stopped after it
+        void evolve(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, int nChildren);
+
+        // workers produce, rate and insert children until stop(), the caller does not wait
+        void start(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData);
+        void waitForChildren(long long nChildren); // until the number of rated children
+        // waits only for children in progress, merges statistics of calculations into the net of start(),
+        // so the net must still exist; rethrows the error of a worker
+        void stop();
+        bool isRunning() const;
+
+        long long getNumberOfChildren() const; // rated
+        long long getNumberOfAccepted() const; // children which got into the elite pool
+        double getBusySeconds() const; // sum of working time of all threads
+
+        float getBetterRating();
+        std::vector<float> getBetterGenom();
+
+    private:
+        struct Worker {
+            std::vector<float> vParent0;
+            std::vector<float> vParent1;
+            std::vector<float> vChild;
+        };
+        std::exception_ptr joinRunner();
+        void prepareWorkers(SimpleNeuralNetwork *pNet);
+        void produceChild(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, int nWorker);
+        void countRatedChild();
+        void updateWorstAndBetter();
+
+        int m_nElite;
+        int m_nGenomSize;
+        std::vector<float> m_vWeights; // m_nElite genoms one by one
+        std::vector<float> m_vRatings;
+        int m_nWorstIndex;
+        int m_nBetterIndex;
+        std::shared_timed_mutex m_mtxElite;
+
+        uint64_t m_nRandomSeed;
+        SimpleNeuralCrossover m_nCrossover;
+        float m_nMutateShare;
+        std::atomic<long long> m_nChildren; // started, the number of the random stream
+        std::atomic<long long> m_nRated;
+        std::atomic<long long> m_nAccepted;
+        mutable std::mutex m_mtxRated;
+        std::condition_variable m_cvRated;
+
+        // the background run: the thread drives the pool, every worker of the pool loops until the stop
+        std::thread m_runner;
+        SimpleNeuralTrainingItemList *m_pRunningData;
+        std::atomic<bool> m_bStop;
+        bool m_bRunnerDone; // under m_mtxRated
+        std::exception_ptr m_pRunnerException;
+
+        std::unique_ptr<SimpleNeuralThreadPool> m_pThreadPool;
+        std::vector<SimpleNeuralNetwork> m_vWorkerNets; // one per thread, pNet is free for the caller
+        SimpleNeuralNetwork *m_pWorkerNetsSource;
+        std::vector<Worker> m_vWorkers;
+};
+
+#endif // __SIMPLE_NEURAL_STEADY_STATE_H__
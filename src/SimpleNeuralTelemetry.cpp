@@ -0,0 +1,124 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralTelemetry.h"
+
+#include <sstream>
+#include <limits>
+#include <cmath>
+
+namespace {
+
+// JSON has no infinity and NaN: null there, the empty field in CSV
+void writeNumber(std::ostream &line, double nValue, SimpleNeuralTelemetryFormat nFormat) {
+    if (std::isfinite(nValue)) {
+        line << nValue;
+    } else if (nFormat == SimpleNeuralTelemetryFormat::JsonLines) {
+        line << "null";
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------
+// SimpleNeuralGenerationStats
+
+double SimpleNeuralGenerationStats::getSeconds() const {
+    double nSeconds = 0.0;
+    for (int i = 0; i < (int)SimpleNeuralPhase::Count; ++i) {
+        nSeconds += vSeconds[i];
+    }
+    return nSeconds;
+}
+
+double SimpleNeuralGenerationStats::getEvaluationsPerSecond() const {
+    double nSeconds = vSeconds[(int)SimpleNeuralPhase::Evaluation];
+    return nSeconds > 0.0 ? nEvaluations / nSeconds : 0.0;
+}
+
+// ---------------------------------------------------------------------
+// SimpleNeuralTelemetryWriter
+
+SimpleNeuralTelemetryWriter::SimpleNeuralTelemetryWriter(std::ostream &stream, SimpleNeuralTelemetryFormat nFormat)
+    : m_stream(stream)
+    , m_nFormat(nFormat)
+    , m_nWritten(0)
+{
+}
+
+void SimpleNeuralTelemetryWriter::write(const SimpleNeuralGenerationStats &stats) {
+    // the line is built first and written at once
+    std::ostringstream line;
+    line.precision(std::numeric_limits<float>::max_digits10);
+    if (m_nFormat == SimpleNeuralTelemetryFormat::Csv) {
+        if (m_nWritten == 0) {
+            line << "generation";
+            for (int i = 0; i < (int)SimpleNeuralPhase::Count; ++i) {
+                line << "," << getPhaseName(SimpleNeuralPhase(i)) << "_s";
+            }
+            line << ",total_s,evaluations,evaluations_per_s,better,median,worst\n";
+        }
+        line << stats.nGeneration;
+        for (int i = 0; i < (int)SimpleNeuralPhase::Count; ++i) {
+            line << "," << stats.vSeconds[i];
+        }
+        line << "," << stats.getSeconds()
+            << "," << stats.nEvaluations
+            << "," << stats.getEvaluationsPerSecond()
+            << ",";
+        writeNumber(line, stats.nBetterRating, m_nFormat);
+        line << ",";
+        writeNumber(line, stats.nMedianRating, m_nFormat);
+        line << ",";
+        writeNumber(line, stats.nWorstRating, m_nFormat);
+        line << "\n";
+    } else {
+        line << "{\"generation\":" << stats.nGeneration;
+        for (int i = 0; i < (int)SimpleNeuralPhase::Count; ++i) {
+            line << ",\"" << getPhaseName(SimpleNeuralPhase(i)) << "_s\":" << stats.vSeconds[i];
+        }
+        line << ",\"total_s\":" << stats.getSeconds()
+            << ",\"evaluations\":" << stats.nEvaluations
+            << ",\"evaluations_per_s\":" << stats.getEvaluationsPerSecond()
+            << ",\"better\":";
+        writeNumber(line, stats.nBetterRating, m_nFormat);
+        line << ",\"median\":";
+        writeNumber(line, stats.nMedianRating, m_nFormat);
+        line << ",\"worst\":";
+        writeNumber(line, stats.nWorstRating, m_nFormat);
+        line << "}\n";
+    }
+    m_stream << line.str();
+    m_stream.flush();
+    ++m_nWritten;
+}
+
+int SimpleNeuralTelemetryWriter::getNumberOfWritten() const {
+    return m_nWritten;
+}
+
+const char *SimpleNeuralTelemetryWriter::getPhaseName(SimpleNeuralPhase nPhase) {
+    static const char *vNames[] = {"sort", "mutation", "crossover", "evaluation", "io"};
+    return vNames[(int)nPhase];
+}
@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_TELEMETRY_H__
+#define __SIMPLE_NEURAL_TELEMETRY_H__
+
+#include <ostream>
+
+enum class SimpleNeuralPhase {
+    Sort, // sort() - selection of better genoms
+    Mutation,
+    Crossover,
+    Evaluation, // all calculateRating...() calls
+    IO, // printFirstRatings() and the time added by the caller
+    Count
+};
+
+enum class SimpleNeuralTelemetryFormat {
+    JsonLines, // one JSON object per line
+    Csv // header line and one line per generation
+};
+
+// Statistics of one generation of SimpleNeuralGenomList
+struct SimpleNeuralGenerationStats {
+    long long nGeneration = 0;
+    double vSeconds[(int)SimpleNeuralPhase::Count] = {}; // wall time by phases
+    long long nEvaluations = 0; // rated genoms
+    // median and worst of finite ratings of not rejected genoms (NaN if there are none),
+    // not finite values are written as null in JSON and as the empty field in CSV
+    float nBetterRating = 0.0f;
+    float nMedianRating = 0.0f;
+    float nWorstRating = 0.0f;
+
+    double getSeconds() const; // of all phases
+    double getEvaluationsPerSecond() const; // per second of the evaluation phase
+};
+
+// Writes statistics of generations as a machine-readable stream
+class SimpleNeuralTelemetryWriter {
+    public:
+        SimpleNeuralTelemetryWriter(std::ostream &stream, SimpleNeuralTelemetryFormat nFormat);
+        void write(const SimpleNeuralGenerationStats &stats);
+        int getNumberOfWritten() const;
+
+        static const char *getPhaseName(SimpleNeuralPhase nPhase);
+
+    private:
+        std::ostream &m_stream;
+        SimpleNeuralTelemetryFormat m_nFormat;
+        int m_nWritten;
+};
+
+#endif // __SIMPLE_NEURAL_TELEMETRY_H__
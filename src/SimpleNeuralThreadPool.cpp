@@ -0,0 +1,195 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimpleNeuralThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+// ---------------------------------------------------------------------
+// SimpleNeuralThreadPool
+
+SimpleNeuralThreadPool::SimpleNeuralThreadPool(int nNumberOfThreads) {
+    m_nNumberOfThreads = std::max(1, nNumberOfThreads);
+    m_pRanges.reset(new WorkerRange[m_nNumberOfThreads]);
+    for (int i = 0; i < m_nNumberOfThreads; ++i) {
+        m_pRanges[i].nBegin = 0;
+        m_pRanges[i].nEnd = 0;
+    }
+    m_pJob = nullptr;
+    m_nJobGeneration = 0;
+    m_nWorkersInJob = 0;
+    m_bStop = false;
+    m_nBusyNanoseconds = 0;
+    for (int i = 1; i < m_nNumberOfThreads; ++i) {
+        m_vThreads.emplace_back(&SimpleNeuralThreadPool::workerLoop, this, i);
+    }
+}
+
+SimpleNeuralThreadPool::~SimpleNeuralThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mtxJob);
+        m_bStop = true;
+    }
+    m_cvStart.notify_all();
+    for (int i = 0; i < m_vThreads.size(); ++i) {
+        m_vThreads[i].join();
+    }
+}
+
+int SimpleNeuralThreadPool::getNumberOfThreads() const {
+    return m_nNumberOfThreads;
+}
+
+double SimpleNeuralThreadPool::getBusySeconds() const {
+    return m_nBusyNanoseconds.load() / 1000000000.0;
+}
+
+int SimpleNeuralThreadPool::getDefaultNumberOfThreads() {
+    int nThreads = std::thread::hardware_concurrency();
+    return nThreads > 0 ? nThreads : 1;
+}
+
+void SimpleNeuralThreadPool::parallelFor(int nBegin, int nEnd, const std::function<void(int nWorker, int nIndex)> &func) {
+    if (nEnd <= nBegin) {
+        return;
+    }
+    if (m_nNumberOfThreads == 1) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = nBegin; i < nEnd; ++i) {
+            func(0, i);
+        }
+        auto end = std::chrono::steady_clock::now();
+        m_nBusyNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        return;
+    }
+
+    // initial split: contiguous equal parts
+    int nCount = nEnd - nBegin;
+    for (int i = 0; i < m_nNumberOfThreads; ++i) {
+        std::lock_guard<std::mutex> lock(m_pRanges[i].mtx);
+        m_pRanges[i].nBegin = nBegin + (long long)nCount * i / m_nNumberOfThreads;
+        m_pRanges[i].nEnd = nBegin + (long long)nCount * (i + 1) / m_nNumberOfThreads;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mtxJob);
+        m_pJob = &func;
+        m_pJobException = nullptr;
+        m_nWorkersInJob = m_nNumberOfThreads - 1;
+        ++m_nJobGeneration;
+    }
+    m_cvStart.notify_all();
+
+    runWorker(0);
+
+    std::exception_ptr pException;
+    {
+        std::unique_lock<std::mutex> lock(m_mtxJob);
+        m_cvDone.wait(lock, [this]() { return m_nWorkersInJob == 0; });
+        m_pJob = nullptr;
+        pException = m_pJobException;
+        m_pJobException = nullptr;
+    }
+    if (pException) {
+        std::rethrow_exception(pException);
+    }
+}
+
+void SimpleNeuralThreadPool::workerLoop(int nWorker) {
+    long long nSeenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mtxJob);
+            m_cvStart.wait(lock, [&]() { return m_bStop || m_nJobGeneration != nSeenGeneration; });
+            if (m_bStop) {
+                return;
+            }
+            nSeenGeneration = m_nJobGeneration;
+        }
+        runWorker(nWorker);
+        {
+            std::lock_guard<std::mutex> lock(m_mtxJob);
+            --m_nWorkersInJob;
+        }
+        m_cvDone.notify_one();
+    }
+}
+
+void SimpleNeuralThreadPool::runWorker(int nWorker) {
+    const std::function<void(int, int)> &func = *m_pJob;
+    auto start = std::chrono::steady_clock::now();
+    int nIndex;
+    while (popOwn(nWorker, nIndex) || stealFromOthers(nWorker, nIndex)) {
+        try {
+            func(nWorker, nIndex);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mtxJob);
+            if (!m_pJobException) {
+                m_pJobException = std::current_exception();
+            }
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    m_nBusyNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+bool SimpleNeuralThreadPool::popOwn(int nWorker, int &nIndex) {
+    WorkerRange &range = m_pRanges[nWorker];
+    std::lock_guard<std::mutex> lock(range.mtx);
+    if (range.nBegin >= range.nEnd) {
+        return false;
+    }
+    nIndex = range.nBegin;
+    ++range.nBegin;
+    return true;
+}
+
+bool SimpleNeuralThreadPool::stealFromOthers(int nWorker, int &nIndex) {
+    for (int i = 1; i < m_nNumberOfThreads; ++i) {
+        int nVictim = (nWorker + i) % m_nNumberOfThreads;
+        int nStolenBegin;
+        int nStolenEnd;
+        {
+            WorkerRange &victim = m_pRanges[nVictim];
+            std::lock_guard<std::mutex> lock(victim.mtx);
+            int nLeft = victim.nEnd - victim.nBegin;
+            if (nLeft <= 0) {
+                continue;
+            }
+            // take the back half (at least one item)
+            int nSteal = (nLeft + 1) / 2;
+            nStolenEnd = victim.nEnd;
+            nStolenBegin = victim.nEnd - nSteal;
+            victim.nEnd = nStolenBegin;
+        }
+        nIndex = nStolenBegin;
+        WorkerRange &own = m_pRanges[nWorker];
+        std::lock_guard<std::mutex> lock(own.mtx);
+        own.nBegin = nStolenBegin + 1;
+        own.nEnd = nStolenEnd;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,81 @@
+/*
+MIT License
+
+Copyright (c) 2022 Evgenii Sopov (mrseakg@gmail.com)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __SIMPLE_NEURAL_THREAD_POOL_H__
+#define __SIMPLE_NEURAL_THREAD_POOL_H__
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <atomic>
+
+// Persistent pool of worker threads. The calling thread works too (as worker 0),
+// so a pool of N threads starts only N-1 system threads.
+// parallelFor() splits the range between workers, a worker which finished
+// its own part steals the half of the rest from the others.
+// Nested parallelFor() (from the task) is not supported.
+class SimpleNeuralThreadPool {
+    public:
+        explicit SimpleNeuralThreadPool(int nNumberOfThreads);
+        ~SimpleNeuralThreadPool();
+
+        int getNumberOfThreads() const;
+        // sum of time of all workers in parallelFor() tasks, without waiting for the work
+        double getBusySeconds() const;
+        void parallelFor(int nBegin, int nEnd, const std::function<void(int nWorker, int nIndex)> &func);
+
+        static int getDefaultNumberOfThreads();
+
+    private:
+        struct WorkerRange {
+            std::mutex mtx;
+            int nBegin;
+            int nEnd;
+        };
+
+        void workerLoop(int nWorker);
+        void runWorker(int nWorker);
+        bool popOwn(int nWorker, int &nIndex);
+        bool stealFromOthers(int nWorker, int &nIndex);
+
+        int m_nNumberOfThreads;
+        std::vector<std::thread> m_vThreads;
+        std::unique_ptr<WorkerRange[]> m_pRanges;
+
+        std::mutex m_mtxJob;
+        std::condition_variable m_cvStart;
+        std::condition_variable m_cvDone;
+        const std::function<void(int, int)> *m_pJob;
+        long long m_nJobGeneration;
+        int m_nWorkersInJob;
+        bool m_bStop;
+        std::exception_ptr m_pJobException;
+        std::atomic<long long> m_nBusyNanoseconds;
+};
+
+#endif // __SIMPLE_NEURAL_THREAD_POOL_H__
@@ -0,0 +1,94 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralAnytimeTrainer.h"
+
+#include <vector>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <limits>
+#include <cstdlib>
+
+int main() {
+    std::srand(3);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 2000; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z});
+    }
+    SimpleNeuralNetwork net({3, 64, 64, 1});
+
+    // the deadline: the better genom so far, the time is not less than the budget
+    // (the list is rated before, so the deadline can stop only generations)
+    SimpleNeuralGenomList genoms(10, 20, 20);
+    genoms.setNumberOfThreads(2);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &trainingData);
+    SimpleNeuralAnytimeTrainer trainer(&genoms);
+    SimpleNeuralTrainingResult result = trainer.train(&net, &trainingData, SimpleNeuralBudget(0.3));
+    if (result.nReason != SimpleNeuralStopReason::Deadline) {
+        std::cout << "Expected stop by deadline" << std::endl;
+        return 1;
+    }
+    // the upper limit is only against the hang, a loaded machine can be much slower
+    if (!(result.nSeconds >= 0.3 && result.nSeconds < 30.0)) {
+        std::cout << "Expected about 0.3s, but got " << result.nSeconds << "s" << std::endl;
+        return 1;
+    }
+    if (!(result.nRating < std::numeric_limits<float>::infinity()) || result.nRating != genoms.getBetterRating()
+        || result.vGenom != genoms.getBetterGenom().getGenom()
+    ) {
+        std::cout << "Expected the better genom of the list, but got rating " << result.nRating << std::endl;
+        return 1;
+    }
+
+    // the stopped generation: not rated children are rejected, the better genom stays
+    float nBetterRating = genoms.getBetterRating();
+    SimpleNeuralCancellationToken token;
+    token.cancel();
+    SimpleNeuralBudget cancelled;
+    cancelled.setCancellationToken(&token);
+    genoms.setBudget(&cancelled);
+    genoms.sort();
+    genoms.mutateAndMix(&net);
+    genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+    genoms.setBudget(nullptr);
+    // only children of this generation, better genoms can be rejected by the deadline before
+    int nRejectedChildren = 0;
+    for (int i = 10; i < genoms.list().size(); ++i) {
+        nRejectedChildren += genoms.list()[i].isRejected() ? 1 : 0;
+    }
+    if (nRejectedChildren != 40 || genoms.getBetterRating() != nBetterRating) {
+        std::cout << "Expected 40 rejected children and rating " << nBetterRating << ", but got "
+            << nRejectedChildren << " and " << genoms.getBetterRating() << std::endl;
+        return 1;
+    }
+
+    // cancellation from other thread: the stop reason, not the time (the budget is much longer)
+    token.reset();
+    std::thread canceller([&token]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        token.cancel();
+    });
+    SimpleNeuralBudget budget(60.0, &token);
+    result = trainer.train(&net, &trainingData, budget);
+    canceller.join();
+    if (result.nReason != SimpleNeuralStopReason::Cancelled) {
+        std::cout << "Expected cancel after 0.2s, but got stop after " << result.nSeconds << "s" << std::endl;
+        return 1;
+    }
+    if (!(result.nRating <= nBetterRating)) {
+        std::cout << "Expected rating not more than " << nBetterRating << ", but got " << result.nRating << std::endl;
+        return 1;
+    }
+
+    // the target rating
+    trainer.setTargetRating(result.nRating * 2.0f);
+    result = trainer.train(&net, &trainingData, SimpleNeuralBudget(60.0));
+    if (result.nReason != SimpleNeuralStopReason::TargetRating || result.nGenerations != 0) {
+        std::cout << "Expected reached target without generations" << std::endl;
+        return 1;
+    }
+    return 0;
+}
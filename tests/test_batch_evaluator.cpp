@@ -0,0 +1,55 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralBatchEvaluator.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+int main() {
+    std::srand(42);
+    // 45 samples - the last tile is not full
+    SimpleNeuralTrainingItemList trainingData(3, 2);
+    for (int i = 0; i < 45; ++i) {
+        float x = float(std::rand() % 100);
+        float y = float(std::rand() % 100);
+        float z = float(std::rand() % 100);
+        trainingData.addItem({x, y, z}, {x + y, y - z});
+    }
+
+    SimpleNeuralNetwork net({3, 7, 9, 2});
+    SimpleNeuralGenomList genoms(4, 5, 6);
+    genoms.fillRandom(&net);
+
+    genoms.calculateRatingForAll(&net, &trainingData);
+    std::vector<float> vExpected;
+    for (int i = 0; i < genoms.list().size(); ++i) {
+        vExpected.push_back(genoms.list()[i].getRating());
+    }
+
+    SimpleNeuralBatchEvaluator evaluator(&net, &trainingData, 4);
+    genoms.calculateRatingForAll(&evaluator);
+    for (int i = 0; i < genoms.list().size(); ++i) {
+        if (genoms.list()[i].getRating() != vExpected[i]) {
+            std::cout << "Genom " << i << ": expected rating " << vExpected[i]
+                << ", but got " << genoms.list()[i].getRating() << std::endl;
+            return 1;
+        }
+    }
+
+    genoms.setNumberOfThreads(3);
+    genoms.calculateRatingForAll(&evaluator);
+    for (int i = 0; i < genoms.list().size(); ++i) {
+        if (genoms.list()[i].getRating() != vExpected[i]) {
+            std::cout << "Genom " << i << " (3 threads): expected rating " << vExpected[i]
+                << ", but got " << genoms.list()[i].getRating() << std::endl;
+            return 1;
+        }
+    }
+
+    long long nExpectedCounter = 2 * 15 * 45;
+    if (evaluator.getGenomSamplesCounter() != nExpectedCounter) {
+        std::cout << "Expected " << nExpectedCounter << " genom-samples, but got " << evaluator.getGenomSamplesCounter() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralCheckpoint.h"
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <stdexcept>
+
+void runGenerations(SimpleNeuralGenomList &genoms, SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, int nGenerations) {
+    for (int n = 0; n < nGenerations; ++n) {
+        genoms.sort();
+        genoms.mutateAndMix(pNet);
+        genoms.calculateRatingForMutatedAndMixed(pNet, pTrainingData);
+    }
+}
+
+int main() {
+    std::srand(4);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 50; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z});
+    }
+    SimpleNeuralNetwork net({3, 4, 1});
+    std::string sFilename = "test_checkpoint.bin";
+
+    // the resumed run is the same as the run without the break
+    SimpleNeuralGenomList full(5, 10, 10);
+    full.setRandomSeed(5);
+    full.setMiniBatch(20, 4);
+    full.setRacing(true);
+    full.setSelfAdaptiveMutation(true);
+    full.fillRandom(&net);
+    full.calculateRatingForAll(&net, &trainingData);
+    runGenerations(full, &net, &trainingData, 6);
+    {
+        SimpleNeuralCheckpoint checkpoint;
+        full.getCheckpoint(checkpoint);
+        SimpleNeuralCheckpointWriter writer;
+        writer.write(checkpoint, sFilename);
+        runGenerations(full, &net, &trainingData, 7);
+        writer.wait();
+        if (writer.getNumberOfWritten() != 1) {
+            std::cout << "Expected 1 written checkpoint, but got " << writer.getNumberOfWritten() << std::endl;
+            return 1;
+        }
+    }
+    if (std::ifstream((sFilename + ".tmp").c_str()).good()) {
+        std::cout << "Expected no temporary file" << std::endl;
+        return 1;
+    }
+
+    // snapshots given during the write do not wait, the last one is always written
+    {
+        SimpleNeuralCheckpointWriter writer;
+        std::string sOther = "test_checkpoint_other.bin";
+        for (int i = 0; i < 5; ++i) {
+            SimpleNeuralCheckpoint snapshot;
+            full.getCheckpoint(snapshot);
+            snapshot.nGeneration = 100 + i;
+            writer.write(snapshot, sOther);
+        }
+        writer.wait();
+        if (writer.getNumberOfWritten() + writer.getNumberOfReplaced() != 5) {
+            std::cout << "Expected 5 written or replaced checkpoints, but got " << writer.getNumberOfWritten()
+                << " and " << writer.getNumberOfReplaced() << std::endl;
+            return 1;
+        }
+        SimpleNeuralCheckpoint last;
+        last.load(sOther);
+        std::remove(sOther.c_str());
+        if (last.nGeneration != 104) {
+            std::cout << "Expected the last checkpoint of generation 104, but got " << last.nGeneration << std::endl;
+            return 1;
+        }
+    }
+
+    SimpleNeuralCheckpoint checkpoint;
+    checkpoint.load(sFilename);
+    SimpleNeuralGenomList resumed(5, 10, 10);
+    resumed.setMiniBatch(20, 4);
+    resumed.setRacing(true);
+    resumed.setSelfAdaptiveMutation(true);
+    resumed.setCheckpoint(checkpoint, &net);
+    if (resumed.getGeneration() != 6) {
+        std::cout << "Expected generation 6, but got " << resumed.getGeneration() << std::endl;
+        return 1;
+    }
+    runGenerations(resumed, &net, &trainingData, 7);
+    for (int i = 0; i < full.list().size(); ++i) {
+        if (full.list()[i].getGenom() != resumed.list()[i].getGenom()
+            || full.list()[i].getRating() != resumed.list()[i].getRating()
+            || full.list()[i].getSigma() != resumed.list()[i].getSigma()
+        ) {
+            std::cout << "Expected rating " << full.list()[i].getRating() << " of genom " << i
+                << ", but got " << resumed.list()[i].getRating() << std::endl;
+            return 1;
+        }
+    }
+
+    // checkpoint which does not fit the network or the list is not restored
+    SimpleNeuralNetwork otherNet({3, 5, 1});
+    SimpleNeuralCheckpoint shortWeights = checkpoint;
+    shortWeights.vWeights.pop_back();
+    SimpleNeuralCheckpoint shortRejected = checkpoint;
+    shortRejected.vRejected.pop_back();
+    SimpleNeuralCheckpoint shortSigmas = checkpoint;
+    shortSigmas.vSigmas.pop_back();
+    SimpleNeuralCheckpoint badOrder = checkpoint;
+    badOrder.vMiniBatchOrder.assign(trainingData.size(), trainingData.size());
+    std::vector<std::pair<const SimpleNeuralCheckpoint *, SimpleNeuralNetwork *>> vMismatched = {
+        {&checkpoint, &otherNet}, {&shortWeights, &net}, {&shortRejected, &net}, {&shortSigmas, &net}, {&badOrder, &net}
+    };
+    long long nResumedGeneration = resumed.getGeneration();
+    for (int i = 0; i < vMismatched.size(); ++i) {
+        bool bThrown = false;
+        try {
+            resumed.setCheckpoint(*vMismatched[i].first, vMismatched[i].second);
+        } catch (const std::runtime_error &) {
+            bThrown = true;
+        }
+        if (!bThrown || resumed.getGeneration() != nResumedGeneration) {
+            std::cout << "Expected exception on mismatched checkpoint " << i << " and generation "
+                << nResumedGeneration << ", but got " << resumed.getGeneration() << std::endl;
+            return 1;
+        }
+    }
+
+    // broken file is not loaded
+    std::ofstream broken(sFilename.c_str(), std::ios::binary | std::ios::trunc);
+    broken << "this is not a checkpoint of genoms";
+    broken.close();
+    bool bThrown = false;
+    try {
+        checkpoint.load(sFilename);
+    } catch (const std::exception &) {
+        bThrown = true;
+    }
+    std::remove(sFilename.c_str());
+    if (!bThrown) {
+        std::cout << "Expected exception on broken checkpoint" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralCmaEs.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+int main() {
+    // normal values for the samples
+    SimpleNeuralRandom random(1, 2);
+    std::vector<float> vGaussian(100001);
+    random.fillGaussian(vGaussian.data(), vGaussian.size());
+    double nMean = 0.0;
+    double nVariance = 0.0;
+    for (int i = 0; i < vGaussian.size(); ++i) {
+        nMean += vGaussian[i];
+        nVariance += vGaussian[i] * vGaussian[i];
+    }
+    nMean /= vGaussian.size();
+    nVariance = nVariance / vGaussian.size() - nMean * nMean;
+    if (std::fabs(nMean) > 0.02 || std::fabs(nVariance - 1.0) > 0.02) {
+        std::cout << "Expected N(0, 1), but got mean " << nMean << " and variance " << nVariance << std::endl;
+        return 1;
+    }
+
+    std::srand(10);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 50; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z});
+    }
+    SimpleNeuralNetwork net({3, 4, 1});
+    std::vector<float> vStart = net.getGenom();
+    SimpleNeuralGenom start(vStart.data(), vStart.size(), 0.0f);
+    start.calculateRating(&net, &trainingData);
+
+    // the result does not depend on the number of threads
+    std::vector<float> vExpected;
+    for (int nThreads = 1; nThreads <= 3; nThreads += 2) {
+        SimpleNeuralCmaEs cma(&net);
+        cma.setNumberOfThreads(nThreads);
+        cma.setRandomSeed(4);
+        for (int n = 0; n < 300; ++n) {
+            cma.step(&trainingData);
+        }
+        if (cma.getNumberOfEvaluations() != 300 * cma.getPopulation()) {
+            std::cout << "Expected " << 300 * cma.getPopulation() << " evaluations, but got " << cma.getNumberOfEvaluations() << std::endl;
+            return 1;
+        }
+        if (!(cma.getBetterRating() < start.getRating() * 0.01f)) {
+            std::cout << "Expected rating less than " << start.getRating() * 0.01f << ", but got " << cma.getBetterRating() << std::endl;
+            return 1;
+        }
+        if (nThreads == 1) {
+            vExpected = cma.getMean();
+        } else if (vExpected != cma.getMean()) {
+            std::cout << "Expected the same mean with " << nThreads << " threads" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralDeltaEvaluator.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+int main() {
+    std::srand(42);
+    SimpleNeuralTrainingItemList trainingData(3, 2);
+    for (int i = 0; i < 40; ++i) {
+        float x = float(std::rand() % 100) / 10.0f;
+        float y = float(std::rand() % 100) / 10.0f;
+        float z = float(std::rand() % 100) / 10.0f;
+        trainingData.addItem({x, y, z}, {x + y, y - z});
+    }
+
+    SimpleNeuralNetwork net({3, 6, 5, 2});
+    SimpleNeuralGenomList genoms(4, 6, 6);
+    genoms.setRandomSeed(5);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &trainingData);
+
+    SimpleNeuralDeltaEvaluator evaluator(&net, &trainingData);
+    evaluator.setDenseThreshold(1000.0f); // always by delta
+
+    for (int n = 0; n < 3; ++n) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&evaluator);
+        for (int i = 4; i < genoms.list().size(); ++i) {
+            float nDelta = genoms.list()[i].getRating();
+            SimpleNeuralGenom genom = genoms.list()[i];
+            genom.calculateRating(&net, &trainingData);
+            float nFull = genom.getRating();
+            if (std::fabs(nDelta - nFull) > 1e-4f * std::max(1.0f, nFull)) {
+                std::cout << "Genom " << i << ": full rating " << nFull << ", but delta rating " << nDelta << std::endl;
+                return 1;
+            }
+        }
+    }
+    if (evaluator.getDeltaCounter() != 3 * 12 || evaluator.getFullCounter() != 0) {
+        std::cout << "Expected only delta ratings, got " << evaluator.getDeltaCounter()
+            << " delta, " << evaluator.getFullCounter() << " full" << std::endl;
+        return 1;
+    }
+
+    // dense change - full pass
+    evaluator.setDenseThreshold(0.0f);
+    genoms.sort();
+    genoms.mutateAndMix(&net);
+    genoms.calculateRatingForMutatedAndMixed(&evaluator);
+    if (evaluator.getFullCounter() != 12) {
+        std::cout << "Expected 12 full ratings, got " << evaluator.getFullCounter() << std::endl;
+        return 1;
+    }
+    return 0;
+}
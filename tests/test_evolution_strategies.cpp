@@ -0,0 +1,70 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralEvolutionStrategies.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+static float ratingOf(SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pData, const std::vector<float> &vWeights) {
+    std::vector<float> vCopy = vWeights;
+    SimpleNeuralGenom genom(vCopy.data(), vCopy.size(), 0.0f);
+    genom.calculateRating(pNet, pData);
+    return genom.getRating();
+}
+
+int main() {
+    std::srand(10);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 50; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z});
+    }
+    SimpleNeuralNetwork net({3, 4, 1});
+    std::vector<float> vStart = net.getGenom();
+    float nStartRating = ratingOf(&net, &trainingData, vStart);
+
+    // the result does not depend on the number of threads
+    std::vector<float> vExpected;
+    for (int nThreads = 1; nThreads <= 3; nThreads += 2) {
+        SimpleNeuralEvolutionStrategies es(&net, 20);
+        es.setNumberOfThreads(nThreads);
+        es.setRandomSeed(4);
+        for (int n = 0; n < 300; ++n) {
+            es.step(&trainingData);
+        }
+        float nRating = ratingOf(&net, &trainingData, es.getParameters());
+        if (!(nRating < nStartRating * 0.01f)) {
+            std::cout << "Expected rating less than " << nStartRating * 0.01f << ", but got " << nRating << std::endl;
+            return 1;
+        }
+        if (nThreads == 1) {
+            vExpected = es.getParameters();
+        } else if (vExpected != es.getParameters()) {
+            std::cout << "Expected the same parameters with " << nThreads << " threads" << std::endl;
+            return 1;
+        }
+    }
+
+    // two "processes" rate the halves of pairs and exchange only the ratings
+    SimpleNeuralEvolutionStrategies es0(&net, 20);
+    SimpleNeuralEvolutionStrategies es1(&net, 20);
+    es0.setRandomSeed(4);
+    es1.setRandomSeed(4);
+    std::vector<float> vRatings0(40), vRatings1(40), vRatings(40);
+    for (int n = 0; n < 300; ++n) {
+        es0.ratePairs(&trainingData, 0, 10, vRatings0.data());
+        es1.ratePairs(&trainingData, 10, 20, vRatings1.data());
+        for (int i = 0; i < 40; ++i) {
+            vRatings[i] = i < 20 ? vRatings0[i] : vRatings1[i];
+        }
+        es0.update(vRatings.data());
+        es1.update(vRatings.data());
+    }
+    if (es0.getGeneration() != 300 || es0.getParameters() != vExpected || es1.getParameters() != vExpected) {
+        std::cout << "Expected the same parameters in all workers after 300 generations" << std::endl;
+        return 1;
+    }
+    return 0;
+}
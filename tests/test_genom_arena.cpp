@@ -0,0 +1,136 @@
+#include "SimpleNeuralNetwork.h"
+
+#include <vector>
+#include <iostream>
+#include <stdint.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// every allocation is counted: the generation must not allocate
+static std::atomic<long long> g_nAllocations(0);
+
+void *operator new(std::size_t nSize) {
+    ++g_nAllocations;
+    void *p = std::malloc(nSize == 0 ? 1 : nSize);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+int main() {
+    SimpleNeuralTrainingItemList trainingData(2, 1);
+    for (int i = 0; i < 20; ++i) {
+        trainingData.addItem({float(i), float(2 * i)}, {float(3 * i)});
+    }
+
+    SimpleNeuralNetwork net({2, 5, 3, 1});
+    SimpleNeuralGenomList genoms(3, 4, 4);
+    genoms.fillRandom(&net);
+
+    const std::vector<SimpleNeuralGenom> &list = genoms.list();
+    if (list.size() != 11) {
+        std::cout << "Expected 11 genoms, but got " << list.size() << std::endl;
+        return 1;
+    }
+    for (int i = 0; i < list.size(); ++i) {
+        if (list[i].getSize() != net.getGenomSize()) {
+            std::cout << "Genom " << i << " has wrong size " << list[i].getSize() << std::endl;
+            return 1;
+        }
+        if (reinterpret_cast<uintptr_t>(list[i].getWeights()) % 64 != 0) {
+            std::cout << "Genom " << i << " is not aligned to 64 bytes" << std::endl;
+            return 1;
+        }
+        if (i > 0 && list[i].getWeights() - list[i - 1].getWeights() != 16 * ((net.getGenomSize() + 15) / 16)) {
+            std::cout << "Genom " << i << " is not in the same block" << std::endl;
+            return 1;
+        }
+    }
+
+    // calc from the view is the same as calc with copied genom
+    SimpleNeuralNetwork net2({2, 5, 3, 1});
+    net2.setGenom(list[4].getGenom());
+    float nExpected = net2.calc({3, 4})[0];
+    float nGot = net.calc(list[4].getWeights(), {3, 4})[0];
+    if (nExpected != nGot) {
+        std::cout << "Expected " << nExpected << ", but got " << nGot << std::endl;
+        return 1;
+    }
+
+    // sort moves only views
+    genoms.calculateRatingForAll(&net, &trainingData);
+    std::vector<std::pair<const float *, std::vector<float>>> vBefore;
+    for (int i = 0; i < list.size(); ++i) {
+        vBefore.push_back({list[i].getWeights(), list[i].getGenom()});
+    }
+    genoms.sort();
+    for (int i = 0; i < vBefore.size(); ++i) {
+        bool bFound = false;
+        for (int j = 0; j < list.size(); ++j) {
+            if (list[j].getWeights() == vBefore[i].first) {
+                bFound = list[j].getGenom() == vBefore[i].second;
+            }
+        }
+        if (!bFound) {
+            std::cout << "Genom " << i << " was changed by sort" << std::endl;
+            return 1;
+        }
+    }
+
+    // children are written to their own rows, elites are untouched
+    std::vector<std::vector<float>> vElites;
+    for (int i = 0; i < 3; ++i) {
+        vElites.push_back(list[i].getGenom());
+    }
+    genoms.mutateAndMix(&net);
+    for (int i = 0; i < 3; ++i) {
+        if (list[i].getGenom() != vElites[i]) {
+            std::cout << "Elite " << i << " was changed by mutateAndMix" << std::endl;
+            return 1;
+        }
+    }
+
+    // the copy owns its weights, the list is not changed by it
+    SimpleNeuralGenom copy = list[0];
+    std::vector<float> vFirst = list[0].getGenom();
+    copy.getWeights()[0] += 1.0f;
+    copy.setRating(-1.0f);
+    if (copy.getWeights() == list[0].getWeights() || list[0].getGenom() != vFirst || list[0].getRating() == -1.0f) {
+        std::cout << "Expected the copy independent of the list" << std::endl;
+        return 1;
+    }
+    SimpleNeuralGenom own(vFirst, 2.0f);
+    if (own.getGenom() != vFirst || own.getRating() != 2.0f || own.getSize() != net.getGenomSize()) {
+        std::cout << "Expected the genom with own weights" << std::endl;
+        return 1;
+    }
+
+    // sort and children do not allocate, serial and parallel
+    for (int nThreads = 1; nThreads <= 2; ++nThreads) {
+        genoms.setNumberOfThreads(nThreads);
+        genoms.calculateRatingForAll(&net, &trainingData);
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        long long nAllocations = g_nAllocations;
+        for (int n = 0; n < 5; ++n) {
+            genoms.sort();
+            genoms.mutateAndMix(&net);
+        }
+        if (g_nAllocations != nAllocations) {
+            std::cout << "Expected no allocations in sort and mutateAndMix with " << nThreads << " threads, but got "
+                << g_nAllocations - nAllocations << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralRandom.h"
+
+#include <vector>
+#include <iostream>
+#include <cmath>
+
+int main() {
+    SimpleNeuralNetwork net({3, 4, 5, 2});
+    int nSize = net.getGenomSize();
+    std::vector<float> vParent0(nSize, 1.0f);
+    std::vector<float> vParent1(nSize, 2.0f);
+    std::vector<float> vChild(nSize, 0.0f);
+    SimpleNeuralRandom random(1, 2);
+
+    // every layer is taken from one parent
+    for (int n = 0; n < 20; ++n) {
+        net.mixGenom(vParent0.data(), vParent1.data(), vChild.data(), random, SimpleNeuralCrossover::Layers);
+        // layers: [0, 3), [3, 15), [15, 35), [35, 45)
+        int vBounds[5] = {0, 3, 15, 35, 45};
+        for (int b = 0; b < 4; ++b) {
+            for (int i = vBounds[b]; i < vBounds[b + 1]; ++i) {
+                if (vChild[i] != vChild[vBounds[b]]) {
+                    std::cout << "Layer " << b << " is mixed" << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    // every neuron row is taken from one parent
+    int nFromParent0 = 0;
+    for (int n = 0; n < 20; ++n) {
+        net.mixGenom(vParent0.data(), vParent1.data(), vChild.data(), random, SimpleNeuralCrossover::Neurons);
+        for (int i = 3; i < nSize; i += 3) {
+            // rows of layer 1 have 3 weights
+            if (i < 15 && (vChild[i] != vChild[i + 1] || vChild[i] != vChild[i + 2])) {
+                std::cout << "Neuron at " << i << " is mixed" << std::endl;
+                return 1;
+            }
+        }
+        for (int i = 0; i < nSize; ++i) {
+            nFromParent0 += vChild[i] == 1.0f ? 1 : 0;
+        }
+    }
+    if (nFromParent0 == 0 || nFromParent0 == 20 * nSize) {
+        std::cout << "Expected weights from both parents" << std::endl;
+        return 1;
+    }
+
+    // light or hard mutation always changes something
+    for (int n = 0; n < 100; ++n) {
+        std::vector<float> vGenom(nSize, 0.5f);
+        net.mutateGenom(vGenom.data(), random);
+        int nChanged = 0;
+        for (int i = 0; i < nSize; ++i) {
+            nChanged += vGenom[i] != 0.5f ? 1 : 0;
+            if (vGenom[i] < -1.0f || vGenom[i] > 1.0f) {
+                std::cout << "Weight out of range: " << vGenom[i] << std::endl;
+                return 1;
+            }
+        }
+        if (nChanged == 0) {
+            std::cout << "Genom was not mutated" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
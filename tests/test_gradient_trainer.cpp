@@ -0,0 +1,65 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralGradientTrainer.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+int main() {
+    std::srand(2);
+    SimpleNeuralTrainingItemList trainingData(3, 2);
+    for (int i = 0; i < 100; ++i) {
+        float x = float(std::rand() % 20) / 10.0f;
+        float y = float(std::rand() % 20) / 10.0f;
+        float z = float(std::rand() % 20) / 10.0f;
+        trainingData.addItem({x, y, z}, {x + y + z, x - z});
+    }
+    SimpleNeuralNetwork net({3, 4, 3, 2});
+    std::vector<float> vStart = net.getGenom();
+
+    // the gradient is the same as by finite differences
+    SimpleNeuralGradientTrainer trainer(&net, &trainingData);
+    std::vector<float> vGradient;
+    trainer.calculateGradient(vStart.data(), vGradient);
+    std::vector<float> vWeights = vStart;
+    std::vector<float> vUnused;
+    for (int i = 0; i < vWeights.size(); ++i) {
+        constexpr float nStep = 0.001f;
+        vWeights[i] = vStart[i] + nStep;
+        float nLossPlus = trainer.calculateGradient(vWeights.data(), vUnused);
+        vWeights[i] = vStart[i] - nStep;
+        float nLossMinus = trainer.calculateGradient(vWeights.data(), vUnused);
+        vWeights[i] = vStart[i];
+        float nExpected = (nLossPlus - nLossMinus) / (2.0f * nStep);
+        if (std::fabs(nExpected - vGradient[i]) > 0.02f * std::fabs(nExpected) + 0.01f) {
+            std::cout << "Weight " << i << ": expected gradient " << nExpected << ", but got " << vGradient[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // every optimizer decreases the rating
+    SimpleNeuralGenom start(vStart.data(), vStart.size(), 0.0f);
+    start.calculateRating(&net, &trainingData);
+    SimpleNeuralOptimizer optimizers[] = {SimpleNeuralOptimizer::SGD, SimpleNeuralOptimizer::Momentum, SimpleNeuralOptimizer::Adam};
+    float rates[] = {0.001f, 0.001f, 0.01f};
+    for (int nOptimizer = 0; nOptimizer < 3; ++nOptimizer) {
+        SimpleNeuralGradientTrainer trainer(&net, &trainingData);
+        trainer.setOptimizer(optimizers[nOptimizer]);
+        trainer.setLearningRate(rates[nOptimizer]);
+        trainer.setBatchSize(10);
+        trainer.setRandomSeed(3);
+        std::vector<float> vTrained = vStart;
+        for (int nEpoch = 0; nEpoch < 100; ++nEpoch) {
+            trainer.trainEpoch(vTrained.data());
+        }
+        SimpleNeuralGenom trained(vTrained.data(), vTrained.size(), 0.0f);
+        trained.calculateRating(&net, &trainingData);
+        if (!(trained.getRating() < start.getRating() * 0.1f) || trainer.getNumberOfSteps() != 1000) {
+            std::cout << "Optimizer " << nOptimizer << ": expected rating less than " << start.getRating() * 0.1f
+                << ", but got " << trained.getRating() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
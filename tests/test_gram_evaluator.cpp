@@ -0,0 +1,91 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralGramEvaluator.h"
+
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+#include <cstdlib>
+
+int main() {
+    std::srand(11);
+    SimpleNeuralTrainingItemList trainingData(3, 2);
+    for (int i = 0; i < 1000; ++i) {
+        float x = float(std::rand() % 100) / 10.0f;
+        float y = float(std::rand() % 100) / 10.0f;
+        float z = float(std::rand() % 100) / 10.0f;
+        trainingData.addItem({x, y, z}, {x + y - z, 2.0f * x + z});
+    }
+
+    // the rating without the pass over the data is the rating of the mean squared loss
+    SimpleNeuralNetwork net({3, 9, 6, 2});
+    try {
+        SimpleNeuralGramEvaluator evaluator(&net, &trainingData);
+        std::cout << "Expected exception for the Euclidean loss" << std::endl;
+        return 1;
+    } catch (const std::runtime_error &) {
+    }
+    net.setLoss(SimpleNeuralLoss::MeanSquared);
+    SimpleNeuralGramEvaluator evaluator(&net, &trainingData);
+    if (evaluator.getNumberOfSamples() != 1000) {
+        std::cout << "Expected 1000 samples, but got " << evaluator.getNumberOfSamples() << std::endl;
+        return 1;
+    }
+    SimpleNeuralGenomList genoms(5, 10, 10);
+    genoms.setRandomSeed(2);
+    genoms.fillRandom(&net);
+    for (int i = 0; i < genoms.list().size(); ++i) {
+        std::vector<float> vGenom = genoms.list()[i].getGenom();
+        SimpleNeuralGenom expected(vGenom.data(), vGenom.size(), 0.0f);
+        expected.calculateRating(&net, &trainingData);
+        SimpleNeuralGenom genom(vGenom.data(), vGenom.size(), 0.0f);
+        evaluator.calculateRating(genom);
+        if (std::fabs(genom.getRating() - expected.getRating()) > 1e-4f * expected.getRating()) {
+            std::cout << "Expected rating " << expected.getRating() << ", but got " << genom.getRating() << std::endl;
+            return 1;
+        }
+    }
+
+    // the collapsed matrix gives the outputs of the network
+    std::vector<float> vGenom = net.getGenom();
+    std::vector<double> vMatrix;
+    evaluator.collapse(vGenom.data(), vMatrix);
+    const std::vector<float> vInput = {1.5f, -2.0f, 0.25f};
+    const std::vector<float> &vOutput = net.calc(vInput);
+    for (int k = 0; k < 2; ++k) {
+        double nExpected = 0.0;
+        for (int i = 0; i < 3; ++i) {
+            nExpected += vMatrix[k * 3 + i] * vInput[i];
+        }
+        if (std::fabs(nExpected - vOutput[k]) > 1e-4 * (1.0 + std::fabs(nExpected))) {
+            std::cout << "Expected output " << nExpected << ", but got " << vOutput[k] << std::endl;
+            return 1;
+        }
+    }
+
+    // the genetic algorithm: the same run with any number of threads, the rating goes down
+    std::vector<float> vRatings[2];
+    for (int nRun = 0; nRun < 2; ++nRun) {
+        SimpleNeuralGenomList list(10, 20, 20);
+        list.setRandomSeed(3);
+        list.setNumberOfThreads(nRun == 0 ? 1 : 3);
+        list.fillRandom(&net);
+        list.calculateRatingForAll(&evaluator);
+        float nStartRating = list.getBetterRating();
+        for (int n = 0; n < 300; ++n) {
+            list.sort();
+            list.mutateAndMix(&net);
+            list.calculateRatingForMutatedAndMixed(&evaluator);
+            vRatings[nRun].push_back(list.getBetterRating());
+        }
+        if (!(list.getBetterRating() < nStartRating * 0.001f)) {
+            std::cout << "Expected rating less than " << nStartRating * 0.001f << ", but got " << list.getBetterRating() << std::endl;
+            return 1;
+        }
+    }
+    if (vRatings[0] != vRatings[1]) {
+        std::cout << "Expected the same ratings with 1 and 3 threads" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "SimpleNeuralIslands.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+int main() {
+    std::srand(7);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 40; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z});
+    }
+    SimpleNeuralNetwork net({3, 4, 1});
+
+    // migrant replaces the worst genom only if it's better
+    SimpleNeuralGenomList genoms(2, 3, 3);
+    genoms.setRandomSeed(1);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &trainingData);
+    std::vector<float> vMigrant(net.getGenomSize(), 0.5f);
+    if (genoms.replaceWorstGenom(vMigrant.data(), 1e30f)) {
+        std::cout << "Expected the migrant worse than all genoms is not accepted" << std::endl;
+        return 1;
+    }
+    if (!genoms.replaceWorstGenom(vMigrant.data(), -1.0f) || genoms.getBetterRating() != -1.0f) {
+        std::cout << "Expected better rating -1, but got " << genoms.getBetterRating() << std::endl;
+        return 1;
+    }
+    if (genoms.replaceWorstGenom(vMigrant.data(), -1.0f)) {
+        std::cout << "Expected the copy of genom is not accepted" << std::endl;
+        return 1;
+    }
+
+    // the result does not depend on the number of threads
+    std::vector<float> vExpected;
+    float nExpectedRating = 0.0f;
+    for (int nThreads = 1; nThreads <= 3; nThreads += 2) {
+        SimpleNeuralIslands islands(4, 5, 10, 10);
+        islands.setNumberOfThreads(nThreads);
+        islands.setRandomSeed(21);
+        islands.setMigration(SimpleNeuralMigration::Ring, 3, 2);
+        islands.fillRandom(&net);
+        islands.calculateRatingForAll(&net, &trainingData);
+        islands.evolve(&net, &trainingData, 10);
+        islands.evolve(&net, &trainingData, 5);
+        if (islands.getGeneration() != 15) {
+            std::cout << "Expected generation 15, but got " << islands.getGeneration() << std::endl;
+            return 1;
+        }
+        if (islands.getNumberOfMigrants() == 0) {
+            std::cout << "Expected migrants between islands, but got 0" << std::endl;
+            return 1;
+        }
+        float nBetter = islands.getBetterRating();
+        for (int i = 0; i < islands.getNumberOfIslands(); ++i) {
+            if (islands.island(i).getBetterRating() < nBetter) {
+                std::cout << "Island " << i << " has better rating than " << nBetter << std::endl;
+                return 1;
+            }
+        }
+        if (nThreads == 1) {
+            vExpected = islands.getBetterGenom().getGenom();
+            nExpectedRating = nBetter;
+        } else if (vExpected != islands.getBetterGenom().getGenom() || nExpectedRating != nBetter) {
+            std::cout << "Expected rating " << nExpectedRating << ", but got " << nBetter << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralLeastSquares.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+int main() {
+    std::srand(12);
+    // out = A * in exactly
+    const float A[2][3] = {{1.0f, 2.0f, -1.0f}, {0.5f, 0.0f, 3.0f}};
+    SimpleNeuralTrainingItemList trainingData(3, 2);
+    for (int i = 0; i < 200; ++i) {
+        float x = float(std::rand() % 100) / 10.0f;
+        float y = float(std::rand() % 100) / 10.0f;
+        float z = float(std::rand() % 100) / 10.0f;
+        trainingData.addItem({x, y, z}, {A[0][0] * x + A[0][1] * y + A[0][2] * z, A[1][0] * x + A[1][1] * y + A[1][2] * z});
+    }
+
+    // the map in the last layer (wide middle) and in the first layer (narrow middle)
+    std::vector<std::vector<int>> vNets = {{3, 2}, {3, 5, 4, 2}, {3, 2, 2}};
+    for (int n = 0; n < vNets.size(); ++n) {
+        SimpleNeuralNetwork net(vNets[n]);
+        SimpleNeuralLeastSquares solver(&net);
+        solver.accumulate(&trainingData);
+        solver.solve();
+        for (int k = 0; k < 2; ++k) {
+            for (int i = 0; i < 3; ++i) {
+                if (std::fabs(solver.getMatrix()[k * 3 + i] - A[k][i]) > 1e-4) {
+                    std::cout << "Expected M[" << k << "][" << i << "] = " << A[k][i]
+                        << ", but got " << solver.getMatrix()[k * 3 + i] << std::endl;
+                    return 1;
+                }
+            }
+        }
+        std::vector<float> vGenom = solver.getGenom();
+        SimpleNeuralGenom genom(vGenom.data(), vGenom.size(), 0.0f);
+        genom.calculateRating(&net, &trainingData);
+        if (genom.getRating() > 1e-3f) {
+            std::cout << "Net " << n << ": expected rating 0, but got " << genom.getRating() << std::endl;
+            return 1;
+        }
+    }
+
+    // the middle layer is too narrow for the map
+    SimpleNeuralNetwork narrow({3, 1, 2});
+    SimpleNeuralLeastSquares solver(&narrow);
+    solver.accumulate(&trainingData);
+    solver.solve();
+    bool bThrown = false;
+    try {
+        solver.getGenom();
+    } catch (const std::exception &) {
+        bThrown = true;
+    }
+    if (!bThrown) {
+        std::cout << "Expected exception for the narrow middle layer" << std::endl;
+        return 1;
+    }
+    return 0;
+}
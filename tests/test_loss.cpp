@@ -0,0 +1,113 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralBatchEvaluator.h"
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// the rating by SimpleNeuralNetwork::calc, in the same order of operations
+float expectedRating(SimpleNeuralNetwork &net, SimpleNeuralTrainingItemList &trainingData, const float *pWeights, SimpleNeuralLoss nLoss) {
+    float nSum = 0.0f;
+    for (auto it = trainingData.begin(); it != trainingData.end(); ++it) {
+        const std::vector<float> &vOut = net.calc(pWeights, it->getIn());
+        const std::vector<float> &vExpected = it->getOut();
+        float nLossOfItem = 0.0f;
+        for (int i = 0; i < vOut.size(); ++i) {
+            float d = vExpected[i] - vOut[i];
+            if (nLoss == SimpleNeuralLoss::Euclidean || nLoss == SimpleNeuralLoss::MeanSquared) {
+                nLossOfItem += d * d;
+            } else if (nLoss == SimpleNeuralLoss::MeanAbsolute) {
+                nLossOfItem += std::fabs(d);
+            } else {
+                nLossOfItem = std::max(nLossOfItem, std::fabs(d));
+            }
+        }
+        if (nLoss == SimpleNeuralLoss::Euclidean) {
+            nSum += std::sqrt(nLossOfItem);
+        } else if (nLoss == SimpleNeuralLoss::MaxError) {
+            nSum = std::max(nSum, nLossOfItem);
+        } else {
+            nSum += nLossOfItem / vOut.size();
+        }
+    }
+    return nLoss == SimpleNeuralLoss::MaxError ? nSum : nSum / trainingData.size();
+}
+
+int main() {
+    std::srand(5);
+    SimpleNeuralTrainingItemList trainingData(3, 2);
+    for (int i = 0; i < 100; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z, x - y});
+    }
+    // 4 neurons at once and the rest
+    SimpleNeuralNetwork net({3, 9, 6, 2});
+    std::vector<float> vWeights = net.getGenom();
+    SimpleNeuralGenom genom(vWeights.data(), vWeights.size(), 0.0f);
+
+    const SimpleNeuralLoss vLosses[] = {
+        SimpleNeuralLoss::Euclidean,
+        SimpleNeuralLoss::MeanSquared,
+        SimpleNeuralLoss::MeanAbsolute,
+        SimpleNeuralLoss::MaxError
+    };
+    for (SimpleNeuralLoss nLoss : vLosses) {
+        net.setLoss(nLoss);
+        genom.calculateRating(&net, &trainingData);
+        float nExpected = expectedRating(net, trainingData, vWeights.data(), nLoss);
+        if (genom.getRating() != nExpected) {
+            std::cout << "Expected " << nExpected << ", but got " << genom.getRating() << std::endl;
+            return 1;
+        }
+    }
+
+    // the max error is rejected as soon as one item is worse than the bound
+    float nMax = genom.getRating();
+    int nUsed = genom.calculateRatingOrReject(&net, &trainingData, nMax * 0.5f);
+    if (!genom.isRejected() || nUsed == trainingData.size()) {
+        std::cout << "Expected rejected genom, but used " << nUsed << " items" << std::endl;
+        return 1;
+    }
+    nUsed = genom.calculateRatingOrReject(&net, &trainingData, nMax);
+    if (genom.isRejected() || genom.getRating() != nMax) {
+        std::cout << "Expected not rejected genom with rating " << nMax << ", but got " << genom.getRating() << std::endl;
+        return 1;
+    }
+
+    // the batch evaluator calculates only Euclidean loss
+    bool bThrown = false;
+    try {
+        SimpleNeuralBatchEvaluator evaluator(&net, &trainingData);
+    } catch (const std::exception &) {
+        bThrown = true;
+    }
+    if (!bThrown) {
+        std::cout << "Expected exception for max error in batch evaluator" << std::endl;
+        return 1;
+    }
+
+    // the loss is changed after the rating in threads: copies of the net and the cache use the new loss
+    net.setLoss(SimpleNeuralLoss::Euclidean);
+    SimpleNeuralGenomList genoms(5, 10, 10);
+    genoms.setNumberOfThreads(4);
+    genoms.setRatingCache(100);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &trainingData);
+    for (SimpleNeuralLoss nLoss : vLosses) {
+        net.setLoss(nLoss);
+        genoms.calculateRatingForAll(&net, &trainingData);
+        for (int i = 0; i < genoms.list().size(); ++i) {
+            float nExpected = expectedRating(net, trainingData, genoms.list()[i].getWeights(), nLoss);
+            if (genoms.list()[i].getRating() != nExpected) {
+                std::cout << "Expected " << nExpected << " of genom " << i << " with threads, but got "
+                    << genoms.list()[i].getRating() << std::endl;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
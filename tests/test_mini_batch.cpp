@@ -0,0 +1,46 @@
+#include "SimpleNeuralNetwork.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+int main() {
+    std::srand(5);
+    SimpleNeuralTrainingItemList trainingData(2, 1);
+    for (int i = 0; i < 100; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        trainingData.addItem({x, y}, {x - y});
+    }
+
+    SimpleNeuralNetwork net({2, 5, 1});
+    SimpleNeuralGenomList genoms(4, 8, 8);
+    genoms.setRandomSeed(9);
+    genoms.setMiniBatch(10, 3);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &trainingData);
+
+    for (int n = 1; n <= 6; ++n) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+
+        int nFullRated = 0;
+        for (int i = 0; i < genoms.list().size(); ++i) {
+            SimpleNeuralGenom genom = genoms.list()[i];
+            genom.calculateRating(&net, &trainingData);
+            nFullRated += genom.getRating() == genoms.list()[i].getRating() ? 1 : 0;
+        }
+        if (n % 3 == 0 && nFullRated != genoms.list().size()) {
+            // all genoms (better too) are rated on the full data
+            std::cout << "Generation " << n << ": expected all rated on full data, but only " << nFullRated << std::endl;
+            return 1;
+        }
+        if (n % 3 != 0 && nFullRated > 4) {
+            // children are rated on 10 of 100 items
+            std::cout << "Generation " << n << ": children were rated on full data" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include "SimpleNeuralNetwork.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+int main() {
+    std::srand(42);
+    SimpleNeuralTrainingItemList trainingData(3, 2);
+    for (int i = 0; i < 50; ++i) {
+        float x = float(std::rand() % 100);
+        float y = float(std::rand() % 100);
+        float z = float(std::rand() % 100);
+        trainingData.addItem({x, y, z}, {x + y, y - z});
+    }
+
+    SimpleNeuralNetwork net({3, 8, 8, 2});
+    std::vector<float> vStartGenom = net.getGenom();
+
+    // the same random genoms in both lists
+    SimpleNeuralGenomList serial(5, 10, 10);
+    std::srand(7);
+    serial.fillRandom(&net);
+
+    SimpleNeuralGenomList parallel(5, 10, 10);
+    parallel.setNumberOfThreads(4);
+    net.setGenom(vStartGenom);
+    std::srand(7);
+    parallel.fillRandom(&net);
+
+    if (parallel.getNumberOfThreads() != 4) {
+        std::cout << "Expected 4 threads, but got " << parallel.getNumberOfThreads() << std::endl;
+        return 1;
+    }
+
+    serial.calculateRatingForAll(&net, &trainingData);
+    parallel.calculateRatingForAll(&net, &trainingData);
+    for (int i = 0; i < serial.list().size(); ++i) {
+        if (serial.list()[i].getGenom() != parallel.list()[i].getGenom()) {
+            std::cout << "Genom " << i << " is different" << std::endl;
+            return 1;
+        }
+        if (serial.list()[i].getRating() != parallel.list()[i].getRating()) {
+            std::cout << "Genom " << i << ": serial rating " << serial.list()[i].getRating()
+                << ", but parallel " << parallel.list()[i].getRating() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include "SimpleNeuralNetwork.h"
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+int main() {
+    SimpleNeuralTrainingItemList trainingData(2, 1);
+    for (int i = 0; i < 25; ++i) {
+        trainingData.addItem({float(i), float(i % 7)}, {float(i + i % 7)});
+    }
+    SimpleNeuralNetwork net({2, 4, 1});
+    SimpleNeuralGenomList genoms(5, 20, 20);
+    genoms.setRandomSeed(11);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &trainingData);
+
+    for (int n = 0; n < 3; ++n) {
+        std::vector<float> vRatings;
+        for (int i = 0; i < genoms.list().size(); ++i) {
+            vRatings.push_back(genoms.list()[i].getRating());
+        }
+        std::sort(vRatings.begin(), vRatings.end());
+
+        // the better genom is known without sort
+        if (genoms.getBetterRating() != vRatings[0] || genoms.getBetterGenom().getRating() != vRatings[0]) {
+            std::cout << "Expected better rating " << vRatings[0] << ", but got " << genoms.getBetterRating() << std::endl;
+            return 1;
+        }
+
+        // the first 5 are the better 5 and sorted
+        genoms.sort();
+        for (int i = 0; i < 5; ++i) {
+            if (genoms.list()[i].getRating() != vRatings[i]) {
+                std::cout << "Genom " << i << ": expected " << vRatings[i] << ", but got " << genoms.list()[i].getRating() << std::endl;
+                return 1;
+            }
+        }
+        for (int i = 5; i < genoms.list().size(); ++i) {
+            if (genoms.list()[i].getRating() < vRatings[4]) {
+                std::cout << "Genom " << i << " must be in the first 5" << std::endl;
+                return 1;
+            }
+        }
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "SimpleNeuralNetwork.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+int main() {
+    std::srand(7);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 400; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z});
+    }
+    SimpleNeuralNetwork net({3, 16, 16, 1});
+
+    // a quarter of children is rated on the full data, the others are rejected by the probe
+    SimpleNeuralGenomList genoms(10, 40, 40);
+    genoms.setRandomSeed(1);
+    genoms.setPreScreening(50, 0.25f, 0);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &trainingData);
+    float nStartRating = genoms.getBetterRating();
+    genoms.sort();
+    genoms.mutateAndMix(&net);
+    genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+    if (genoms.getNumberOfScreenedOut() != 60 || genoms.getNumberOfRejected() != 60) {
+        std::cout << "Expected 60 screened out children, but got " << genoms.getNumberOfScreenedOut()
+            << " and " << genoms.getNumberOfRejected() << " rejected" << std::endl;
+        return 1;
+    }
+    for (int i = 0; i < genoms.list().size(); ++i) {
+        const SimpleNeuralGenom &genom = genoms.list()[i];
+        if (!genom.isRejected()) {
+            std::vector<float> vGenom = genom.getGenom();
+            SimpleNeuralGenom expected(vGenom.data(), vGenom.size(), 0.0f);
+            expected.calculateRating(&net, &trainingData);
+            if (expected.getRating() != genom.getRating()) {
+                std::cout << "Expected rating on the full data " << expected.getRating() << ", but got " << genom.getRating() << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // the audit of every generation counts false rejects on the full data (also with mini-batches),
+    // the run is the same without the audit and with any number of threads
+    for (int nMiniBatch = 0; nMiniBatch <= 100; nMiniBatch += 100) {
+        std::vector<float> vRatings[3];
+        float vFalseRejectRates[3];
+        for (int nRun = 0; nRun < 3; ++nRun) {
+            SimpleNeuralGenomList list(10, 40, 40);
+            list.setRandomSeed(1);
+            list.setNumberOfThreads(nRun == 2 ? 3 : 1);
+            list.setMiniBatch(nMiniBatch, 0);
+            list.setPreScreening(50, 0.25f, nRun == 0 ? 0 : 1);
+            list.fillRandom(&net);
+            list.calculateRatingForAll(&net, &trainingData);
+            for (int n = 0; n < 20; ++n) {
+                list.sort();
+                list.mutateAndMix(&net);
+                list.calculateRatingForMutatedAndMixed(&net, &trainingData);
+                if (list.getNumberOfScreenedOut() != 60 || list.getNumberOfRejected() < 60) {
+                    std::cout << "Expected 60 screened out and rejected children, but got "
+                        << list.getNumberOfScreenedOut() << " and " << list.getNumberOfRejected() << std::endl;
+                    return 1;
+                }
+                vRatings[nRun].push_back(list.getBetterRating());
+            }
+            vFalseRejectRates[nRun] = list.getScreeningFalseRejectRate();
+        }
+        if (vRatings[0] != vRatings[1] || vRatings[1] != vRatings[2] || vFalseRejectRates[1] != vFalseRejectRates[2]) {
+            std::cout << "Expected the same run without the audit and with 1 and 3 threads (mini-batch "
+                << nMiniBatch << ")" << std::endl;
+            return 1;
+        }
+        if (!(vFalseRejectRates[1] >= 0.0f && vFalseRejectRates[1] < 0.5f) || (nMiniBatch == 0 && vFalseRejectRates[1] == 0.0f)) {
+            std::cout << "Expected false reject rate between 0 and 0.5, but got " << vFalseRejectRates[1] << std::endl;
+            return 1;
+        }
+    }
+
+    // the screened run still trains
+    for (int n = 0; n < 100; ++n) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+    }
+    if (!(genoms.getBetterRating() < nStartRating * 0.1f)) {
+        std::cout << "Expected rating less than " << nStartRating * 0.1f << ", but got " << genoms.getBetterRating() << std::endl;
+        return 1;
+    }
+
+    // all children promoted: no screening
+    genoms.setPreScreening(50, 1.0f, 0);
+    genoms.sort();
+    genoms.mutateAndMix(&net);
+    genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+    if (genoms.getNumberOfScreenedOut() != 0 || genoms.getNumberOfRejected() != 0) {
+        std::cout << "Expected no screened out children, but got " << genoms.getNumberOfScreenedOut() << std::endl;
+        return 1;
+    }
+    return 0;
+}
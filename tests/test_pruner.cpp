@@ -0,0 +1,115 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralPruner.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+int main() {
+    std::srand(5);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 200; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z});
+    }
+
+    // the network without the neuron gives the same outputs as with zero weights of its outputs
+    SimpleNeuralNetwork net({3, 5, 4, 2});
+    std::vector<float> vGenom = net.getGenom();
+    std::vector<int> vLayers;
+    std::vector<float> vReducedGenom;
+    SimpleNeuralPruner::removeNeuron(net.getLayers(), vGenom, 2, 1, vLayers, vReducedGenom);
+    if (vLayers != std::vector<int>({3, 5, 3, 2}) || vReducedGenom.size() != 3 + 3 * 5 + 5 * 3 + 3 * 2) {
+        std::cout << "Expected layers 3, 5, 3, 2, but got genom size " << vReducedGenom.size() << std::endl;
+        return 1;
+    }
+    SimpleNeuralNetwork reduced(vLayers);
+    reduced.setGenom(vReducedGenom);
+    for (int nM = 0; nM < 2; ++nM) {
+        vGenom[3 + 3 * 5 + 5 * 4 + nM * 4 + 1] = 0.0f;
+    }
+    net.setGenom(vGenom);
+    for (auto it = trainingData.begin(); it != trainingData.end(); ++it) {
+        std::vector<float> vExpected = net.calc(it->getIn());
+        if (reduced.calc(it->getIn()) != vExpected) {
+            std::cout << "Expected the same outputs without the neuron" << std::endl;
+            return 1;
+        }
+    }
+
+    // only the first neuron of every hidden layer is needed, the others add little noise
+    SimpleNeuralNetwork wide({3, 16, 16, 1});
+    vGenom.assign(wide.getGenomSize(), 0.0f);
+    for (int i = 0; i < 3; ++i) {
+        vGenom[i] = 1.0f;
+    }
+    for (int nN = 0; nN < 16; ++nN) {
+        for (int nP = 0; nP < 3; ++nP) {
+            vGenom[3 + nN * 3 + nP] = nN == 0 ? 1.0f : float(std::rand() % 100) / 100.0f;
+        }
+        for (int nP = 0; nP < 16; ++nP) {
+            float nNoise = float(std::rand() % 100) / 100000.0f;
+            vGenom[3 + 16 * 3 + nN * 16 + nP] = nN == 0 ? (nP == 0 ? 1.0f : 0.0f) : nNoise;
+        }
+        vGenom[3 + 16 * 3 + 16 * 16 + nN] = nN == 0 ? 1.0f : float(std::rand() % 100) / 100000.0f;
+    }
+    wide.setGenom(vGenom);
+    SimpleNeuralPruner pruner(&wide);
+    SimpleNeuralPruningResult result = pruner.prune(&trainingData);
+    if (result.vLayers != std::vector<int>({3, 1, 1, 1}) || result.nRemovedNeurons != 30
+        || result.vGenom.size() != 8
+    ) {
+        std::cout << "Expected layers 3, 1, 1, 1, but got " << result.nRemovedNeurons << " removed neurons" << std::endl;
+        return 1;
+    }
+    if (!(result.nRating <= result.nOriginalRating * 1.05f)) {
+        std::cout << "Expected rating in the tolerance of " << result.nOriginalRating << ", but got " << result.nRating << std::endl;
+        return 1;
+    }
+    if (!(result.nCalcSpeedup > 1.0)) {
+        std::cout << "Expected faster calc, but got speedup " << result.nCalcSpeedup << std::endl;
+        return 1;
+    }
+    SimpleNeuralNetwork reducedNet(result.vLayers);
+    reducedNet.setGenom(result.vGenom);
+    SimpleNeuralGenom genom(result.vGenom.data(), result.vGenom.size(), 0.0f);
+    genom.calculateRating(&reducedNet, &trainingData);
+    if (genom.getRating() != result.nRating) {
+        std::cout << "Expected rating " << result.nRating << ", but got " << genom.getRating() << std::endl;
+        return 1;
+    }
+
+    // every hidden neuron takes one input, the last one is not used: only it can be removed
+    SimpleNeuralNetwork split({3, 4, 1});
+    vGenom.assign(split.getGenomSize(), 0.0f);
+    for (int i = 0; i < 3; ++i) {
+        vGenom[i] = 1.0f;
+        vGenom[3 + i * 3 + i] = 1.0f;
+    }
+    for (int nN = 0; nN < 4; ++nN) {
+        vGenom[3 + 4 * 3 + nN] = 1.0f;
+    }
+    split.setGenom(vGenom);
+    SimpleNeuralPruner splitPruner(&split);
+    result = splitPruner.prune(&trainingData);
+    if (result.vLayers != std::vector<int>({3, 3, 1}) || result.nRating != 0.0f) {
+        std::cout << "Expected layers 3, 3, 1 and rating 0, but got " << result.nRemovedNeurons
+            << " removed neurons and rating " << result.nRating << std::endl;
+        return 1;
+    }
+
+    // the fine-tuning brings the rating back after the removal of a needed neuron
+    SimpleNeuralGenomList genoms(10, 20, 20);
+    genoms.setRandomSeed(1);
+    splitPruner.setTolerance(0.0f, 3.0f);
+    splitPruner.setFineTuning(&genoms, 30);
+    result = splitPruner.prune(&trainingData);
+    if (result.nFineTunings == 0 || !(result.nRating <= 3.0f) || result.vLayers[1] >= 3) {
+        std::cout << "Expected removed needed neurons, but got " << result.nFineTunings
+            << " fine-tunings and rating " << result.nRating << std::endl;
+        return 1;
+    }
+    return 0;
+}
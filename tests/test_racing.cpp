@@ -0,0 +1,64 @@
+#include "SimpleNeuralNetwork.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+int main() {
+    std::srand(3);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 60; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z});
+    }
+
+    // racing changes nothing in the selection of better genoms
+    SimpleNeuralNetwork net({3, 6, 6, 1});
+    SimpleNeuralGenomList full(5, 10, 10);
+    full.setRandomSeed(77);
+    full.fillRandom(&net);
+    full.calculateRatingForAll(&net, &trainingData);
+
+    SimpleNeuralGenomList racing(5, 10, 10);
+    racing.setRandomSeed(77);
+    racing.setRacing(true);
+    racing.fillRandom(&net);
+    racing.calculateRatingForAll(&net, &trainingData);
+
+    float nSavedShare = 0.0f;
+    for (int n = 0; n < 10; ++n) {
+        full.sort();
+        racing.sort();
+        for (int i = 0; i < 5; ++i) {
+            if (full.list()[i].getGenom() != racing.list()[i].getGenom()
+                || full.list()[i].getRating() != racing.list()[i].getRating()
+            ) {
+                std::cout << "Generation " << n << ": better genom " << i << " is different" << std::endl;
+                return 1;
+            }
+        }
+        full.mutateAndMix(&net);
+        full.calculateRatingForMutatedAndMixed(&net, &trainingData);
+        racing.mutateAndMix(&net);
+        racing.calculateRatingForMutatedAndMixed(&net, &trainingData);
+        nSavedShare += racing.getRacingSavedShare();
+        if (racing.getBetterRating() != full.getBetterRating()) {
+            std::cout << "Generation " << n << ": expected better rating " << full.getBetterRating()
+                << ", but got " << racing.getBetterRating() << std::endl;
+            return 1;
+        }
+        for (int i = 0; i < racing.list().size(); ++i) {
+            if (racing.list()[i].isRejected() && racing.list()[i].getRating() <= racing.list()[4].getRating()) {
+                std::cout << "Rejected genom " << i << " could be better" << std::endl;
+                return 1;
+            }
+        }
+    }
+    if (nSavedShare <= 0.0f) {
+        std::cout << "Racing did not skip any training item" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralRandom.h"
+
+#include <vector>
+#include <iostream>
+
+int main() {
+    SimpleNeuralRandom random0(123, 0);
+    SimpleNeuralRandom random1(123, 1);
+    SimpleNeuralRandom random0again(123, 0);
+    for (int i = 0; i < 100; ++i) {
+        uint64_t n0 = random0.next();
+        if (n0 != random0again.next()) {
+            std::cout << "The same seed and stream must give the same numbers" << std::endl;
+            return 1;
+        }
+        if (n0 == random1.next()) {
+            std::cout << "Different streams give the same number " << n0 << std::endl;
+            return 1;
+        }
+    }
+    for (int i = 0; i < 1000; ++i) {
+        float f = random0.nextFloat();
+        uint32_t n = random0.nextInt(7);
+        if (f < 0.0f || f >= 1.0f || n >= 7) {
+            std::cout << "Out of range: " << f << " " << n << std::endl;
+            return 1;
+        }
+    }
+
+    SimpleNeuralTrainingItemList trainingData(2, 1);
+    for (int i = 0; i < 30; ++i) {
+        trainingData.addItem({float(i), float(30 - i)}, {30.0f});
+    }
+
+    // the same seed - the same run, the number of threads does not matter
+    SimpleNeuralNetwork net({2, 6, 6, 1});
+    SimpleNeuralGenomList serial(4, 6, 6);
+    serial.setRandomSeed(2022);
+    serial.fillRandom(&net);
+    serial.calculateRatingForAll(&net, &trainingData);
+
+    SimpleNeuralGenomList parallel(4, 6, 6);
+    parallel.setRandomSeed(2022);
+    parallel.setNumberOfThreads(3);
+    parallel.fillRandom(&net);
+    parallel.calculateRatingForAll(&net, &trainingData);
+
+    for (int n = 0; n < 5; ++n) {
+        serial.sort();
+        serial.mutateAndMix(&net);
+        serial.calculateRatingForMutatedAndMixed(&net, &trainingData);
+        parallel.sort();
+        parallel.mutateAndMix(&net);
+        parallel.calculateRatingForMutatedAndMixed(&net, &trainingData);
+    }
+    for (int i = 0; i < serial.list().size(); ++i) {
+        if (serial.list()[i].getGenom() != parallel.list()[i].getGenom()
+            || serial.list()[i].getRating() != parallel.list()[i].getRating()
+        ) {
+            std::cout << "Genom " << i << " is different" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralRatingCache.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+int main() {
+    // exact compare on the same hash
+    SimpleNeuralRatingCache cache(2);
+    std::vector<float> vA = {1.0f, 2.0f, 3.0f};
+    std::vector<float> vB = {1.0f, 2.0f, 3.5f};
+    if (SimpleNeuralRatingCache::hash(vA.data(), 3) == SimpleNeuralRatingCache::hash(vB.data(), 3)) {
+        std::cout << "Expected different hashes of different genoms" << std::endl;
+        return 1;
+    }
+    float nRating = 0.0f;
+    cache.insert(42, vA.data(), 3, 7.0f);
+    if (!cache.find(42, vA.data(), 3, nRating) || nRating != 7.0f) {
+        std::cout << "Expected rating 7, but got " << nRating << std::endl;
+        return 1;
+    }
+    if (cache.find(42, vB.data(), 3, nRating) || cache.getCollisions() != 1) {
+        std::cout << "Expected 1 collision, but got " << cache.getCollisions() << std::endl;
+        return 1;
+    }
+    // the weights differ only in the lowest bit of one weight
+    std::vector<float> vC = vA;
+    vC[1] = std::nextafter(vC[1], 10.0f);
+    if (cache.find(42, vC.data(), 3, nRating) || cache.find(42, vA.data(), 2, nRating) || cache.getCollisions() != 3) {
+        std::cout << "Expected 3 collisions, but got " << cache.getCollisions() << std::endl;
+        return 1;
+    }
+    // the oldest entry is replaced
+    cache.insert(43, vB.data(), 3, 8.0f);
+    cache.insert(44, vB.data(), 3, 9.0f);
+    if (cache.find(42, vA.data(), 3, nRating) || !cache.find(44, vB.data(), 3, nRating)) {
+        std::cout << "Expected the oldest entry to be replaced" << std::endl;
+        return 1;
+    }
+
+    // the cache changes nothing in the ratings
+    std::srand(5);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 40; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z});
+    }
+    SimpleNeuralNetwork net({3, 4, 1});
+    SimpleNeuralGenomList plain(5, 10, 10);
+    plain.setRandomSeed(11);
+    plain.fillRandom(&net);
+    plain.calculateRatingForAll(&net, &trainingData);
+    SimpleNeuralGenomList cached(5, 10, 10);
+    cached.setRandomSeed(11);
+    cached.setRatingCache(100);
+    cached.fillRandom(&net);
+    cached.calculateRatingForAll(&net, &trainingData);
+    for (int n = 0; n < 20; ++n) {
+        plain.sort();
+        plain.mutateAndMix(&net);
+        plain.calculateRatingForMutatedAndMixed(&net, &trainingData);
+        cached.sort();
+        cached.mutateAndMix(&net);
+        cached.calculateRatingForMutatedAndMixed(&net, &trainingData);
+        for (int i = 0; i < plain.list().size(); ++i) {
+            if (plain.list()[i].getRating() != cached.list()[i].getRating()) {
+                std::cout << "Generation " << n << ": expected rating " << plain.list()[i].getRating()
+                    << " of genom " << i << ", but got " << cached.list()[i].getRating() << std::endl;
+                return 1;
+            }
+        }
+    }
+    // a mix of the genom with itself is the same genom
+    if (cached.getRatingCache()->getHits() == 0) {
+        std::cout << "Expected hits of the rating cache, but got 0" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralRemote.h"
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cstdlib>
+#include <stdint.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#endif
+
+int main() {
+#ifndef _WIN32
+    std::srand(9);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 50; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z});
+    }
+    SimpleNeuralNetwork net({3, 5, 5, 1});
+
+    std::string sAddress = "unix:/tmp/test_remote_workers_" + std::to_string(getpid()) + ".sock";
+    std::vector<pid_t> vChildren;
+    {
+        SimpleNeuralRemoteCoordinator coordinator;
+        coordinator.listen(sAddress);
+        // local processes instead of remote hosts
+        for (int i = 0; i < 2; ++i) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                SimpleNeuralRemoteWorker worker(&net, &trainingData);
+                worker.connect(sAddress);
+                worker.serve();
+                _exit(0);
+            }
+            vChildren.push_back(pid);
+        }
+        // this worker drops out after the first frame
+        pid_t pid = fork();
+        if (pid == 0) {
+            int nSocket = SimpleNeuralRemoteWorker::connectSocket(sAddress);
+            char buffer[16];
+            recv(nSocket, buffer, sizeof(buffer), MSG_WAITALL);
+            close(nSocket);
+            _exit(0);
+        }
+        vChildren.push_back(pid);
+        // this worker takes frames and never answers, it leaves when the coordinator closes the connection
+        pid = fork();
+        if (pid == 0) {
+            int nSocket = SimpleNeuralRemoteWorker::connectSocket(sAddress);
+            char buffer[4096];
+            while (recv(nSocket, buffer, sizeof(buffer), 0) > 0) {
+            }
+            close(nSocket);
+            _exit(0);
+        }
+        vChildren.push_back(pid);
+        int nWorkers = coordinator.acceptWorkers(4, 10000);
+        if (nWorkers != 4) {
+            std::cout << "Expected 4 workers, but got " << nWorkers << std::endl;
+            return 1;
+        }
+        coordinator.setTimeout(1000);
+
+        SimpleNeuralGenomList local(5, 10, 10);
+        local.setRandomSeed(3);
+        local.fillRandom(&net);
+        local.calculateRatingForAll(&net, &trainingData);
+        SimpleNeuralGenomList remote(5, 10, 10);
+        remote.setRandomSeed(3);
+        remote.fillRandom(&net);
+        remote.calculateRatingForAll(&coordinator);
+        for (int n = 0; n < 5; ++n) {
+            for (int i = 0; i < local.list().size(); ++i) {
+                if (local.list()[i].getRating() != remote.list()[i].getRating()) {
+                    std::cout << "Generation " << n << ": expected rating " << local.list()[i].getRating()
+                        << " of genom " << i << ", but got " << remote.list()[i].getRating() << std::endl;
+                    return 1;
+                }
+            }
+            local.sort();
+            local.mutateAndMix(&net);
+            local.calculateRatingForMutatedAndMixed(&net, &trainingData);
+            remote.sort();
+            remote.mutateAndMix(&net);
+            remote.calculateRatingForMutatedAndMixed(&coordinator);
+        }
+        if (coordinator.getNumberOfDroppedWorkers() != 2 || coordinator.getNumberOfWorkers() != 2) {
+            std::cout << "Expected 2 dropped workers, but got " << coordinator.getNumberOfDroppedWorkers() << std::endl;
+            return 1;
+        }
+    }
+    for (int i = 0; i < vChildren.size(); ++i) {
+        int nStatus = 0;
+        waitpid(vChildren[i], &nStatus, 0);
+    }
+
+    // the worker answers a frame of wrong size with error and does not allocate for it
+    uint32_t vFrames[2][4] = {
+        {0x524e4e53, 1, 0xFFFFFFFFu, uint32_t(net.getGenomSize())}, // too many genoms
+        {0x524e4e53, 1, 1, uint32_t(net.getGenomSize() + 1)}
+    };
+    for (int f = 0; f < 2; ++f) {
+        int vSockets[2];
+        socketpair(AF_UNIX, SOCK_STREAM, 0, vSockets);
+        SimpleNeuralRemoteWorker worker(&net, &trainingData);
+        worker.attach(vSockets[0]);
+        send(vSockets[1], vFrames[f], sizeof(vFrames[f]), 0);
+        long long nRated = worker.serve();
+        uint32_t vAnswer[4] = {0, 0, 0, 0};
+        recv(vSockets[1], vAnswer, sizeof(vAnswer), MSG_WAITALL);
+        close(vSockets[1]);
+        if (nRated != 0 || vAnswer[1] != 3) {
+            std::cout << "Expected the error frame for frame " << f << ", but got type " << vAnswer[1] << std::endl;
+            return 1;
+        }
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "SimpleNeuralNetwork.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+void runGenerations(SimpleNeuralGenomList &genoms, SimpleNeuralNetwork *pNet, SimpleNeuralTrainingItemList *pTrainingData, int nGenerations) {
+    for (int n = 0; n < nGenerations; ++n) {
+        genoms.sort();
+        genoms.mutateAndMix(pNet);
+        genoms.calculateRatingForMutatedAndMixed(pNet, pTrainingData);
+    }
+}
+
+int main() {
+    std::srand(7);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 50; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z});
+    }
+    SimpleNeuralNetwork net({3, 4, 1});
+
+    // the step of the fixed mutation is not changed
+    SimpleNeuralGenomList fixed(5, 10, 10);
+    fixed.setRandomSeed(2);
+    fixed.fillRandom(&net);
+    fixed.calculateRatingForAll(&net, &trainingData);
+    float nStartRating = fixed.getBetterRating();
+    runGenerations(fixed, &net, &trainingData, 20);
+    for (int i = 0; i < fixed.list().size(); ++i) {
+        if (fixed.list()[i].getSigma() != 0.01f) {
+            std::cout << "Expected step 0.01, but got " << fixed.list()[i].getSigma() << std::endl;
+            return 1;
+        }
+    }
+
+    // steps are inherited and adapted, the run is reproducible with any number of threads
+    std::vector<float> vExpected;
+    for (int nThreads = 1; nThreads <= 3; nThreads += 2) {
+        SimpleNeuralGenomList genoms(5, 10, 10);
+        genoms.setNumberOfThreads(nThreads);
+        genoms.setRandomSeed(2);
+        genoms.setSelfAdaptiveMutation(true);
+        genoms.fillRandom(&net);
+        genoms.calculateRatingForAll(&net, &trainingData);
+        runGenerations(genoms, &net, &trainingData, 200);
+        if (!(genoms.getBetterRating() < nStartRating)) {
+            std::cout << "Expected rating less than " << nStartRating << ", but got " << genoms.getBetterRating() << std::endl;
+            return 1;
+        }
+        std::vector<float> vSigmas;
+        bool bAdapted = false;
+        for (int i = 0; i < genoms.list().size(); ++i) {
+            float nSigma = genoms.list()[i].getSigma();
+            if (!(nSigma >= 1e-5f && nSigma <= 1.0f)) {
+                std::cout << "Expected step in [1e-5, 1], but got " << nSigma << std::endl;
+                return 1;
+            }
+            bAdapted = bAdapted || nSigma != 0.01f;
+            vSigmas.push_back(nSigma);
+        }
+        if (!bAdapted) {
+            std::cout << "Expected adapted steps" << std::endl;
+            return 1;
+        }
+        if (nThreads == 1) {
+            vExpected = vSigmas;
+        } else if (vExpected != vSigmas) {
+            std::cout << "Expected the same steps with " << nThreads << " threads" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "SimpleNeuralSteadyState.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+int main() {
+    std::srand(6);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 40; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        float z = float(std::rand() % 50);
+        trainingData.addItem({x, y, z}, {x + y + z});
+    }
+    SimpleNeuralNetwork net({3, 4, 1});
+
+    // serial run is reproducible
+    std::vector<float> vExpected;
+    for (int nRun = 0; nRun < 2; ++nRun) {
+        SimpleNeuralSteadyState steady(10);
+        steady.setNumberOfThreads(1);
+        steady.setRandomSeed(8);
+        steady.fillRandom(&net);
+        steady.calculateRatingForAll(&net, &trainingData);
+        steady.evolve(&net, &trainingData, 300);
+        if (nRun == 0) {
+            vExpected = steady.getBetterGenom();
+        } else if (vExpected != steady.getBetterGenom()) {
+            std::cout << "Expected the same better genom in the serial runs" << std::endl;
+            return 1;
+        }
+    }
+
+    // the pool stays consistent with many threads
+    SimpleNeuralSteadyState steady(10);
+    steady.setNumberOfThreads(4);
+    steady.setRandomSeed(8);
+    steady.fillRandom(&net);
+    steady.calculateRatingForAll(&net, &trainingData);
+    float nStartRating = steady.getBetterRating();
+    steady.evolve(&net, &trainingData, 300);
+    steady.evolve(&net, &trainingData, 300);
+    if (steady.getNumberOfChildren() < 600) {
+        std::cout << "Expected at least 600 children, but got " << steady.getNumberOfChildren() << std::endl;
+        return 1;
+    }
+    // no barrier after evolve(): the workers go on
+    if (!steady.isRunning()) {
+        std::cout << "Expected running workers after evolve" << std::endl;
+        return 1;
+    }
+    steady.waitForChildren(steady.getNumberOfChildren() + 200);
+    float nRunningRating = steady.getBetterRating();
+    steady.stop();
+    long long nChildren = steady.getNumberOfChildren();
+    if (steady.isRunning() || nChildren < 800 || steady.getBetterRating() > nRunningRating) {
+        std::cout << "Expected stopped workers after 800 children, but got " << nChildren << std::endl;
+        return 1;
+    }
+    steady.stop();
+    if (steady.getNumberOfChildren() != nChildren) {
+        std::cout << "Expected no children after stop, but got " << steady.getNumberOfChildren() - nChildren << std::endl;
+        return 1;
+    }
+    if (steady.getNumberOfAccepted() == 0 || steady.getBetterRating() >= nStartRating) {
+        std::cout << "Expected better rating than " << nStartRating << ", but got " << steady.getBetterRating() << std::endl;
+        return 1;
+    }
+    std::vector<float> vBetter = steady.getBetterGenom();
+    SimpleNeuralGenom better(vBetter.data(), vBetter.size(), 0.0f);
+    better.calculateRating(&net, &trainingData);
+    if (better.getRating() != steady.getBetterRating()) {
+        std::cout << "Expected rating " << better.getRating() << " of better genom, but got " << steady.getBetterRating() << std::endl;
+        return 1;
+    }
+
+    // the net of start() can be destroyed before the running workers
+    SimpleNeuralSteadyState *pRunning = new SimpleNeuralSteadyState(10);
+    pRunning->setNumberOfThreads(2);
+    SimpleNeuralNetwork *pTempNet = new SimpleNeuralNetwork({3, 4, 1});
+    pRunning->fillRandom(pTempNet);
+    pRunning->start(pTempNet, &trainingData);
+    pRunning->waitForChildren(50);
+    delete pTempNet;
+    delete pRunning;
+    return 0;
+}
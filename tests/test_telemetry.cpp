@@ -0,0 +1,142 @@
+#include "SimpleNeuralNetwork.h"
+#include "SimpleNeuralTelemetry.h"
+#include "SimpleNeuralAnytimeTrainer.h"
+
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+
+static int countLines(const std::string &sText) {
+    int nLines = 0;
+    for (int i = 0; i < sText.size(); ++i) {
+        nLines += sText[i] == '\n' ? 1 : 0;
+    }
+    return nLines;
+}
+
+int main() {
+    std::srand(10);
+    SimpleNeuralTrainingItemList trainingData(3, 1);
+    for (int i = 0; i < 50; ++i) {
+        float x = float(std::rand() % 50);
+        float y = float(std::rand() % 50);
+        trainingData.addItem({x, y, 1.0f}, {x + y});
+    }
+    SimpleNeuralNetwork net({3, 4, 1});
+
+    for (int nFormat = 0; nFormat < 2; ++nFormat) {
+        std::ostringstream stream;
+        SimpleNeuralTelemetryWriter writer(stream, nFormat == 0 ? SimpleNeuralTelemetryFormat::JsonLines : SimpleNeuralTelemetryFormat::Csv);
+        SimpleNeuralGenomList genoms(5, 10, 10);
+        genoms.setRandomSeed(3);
+        genoms.setTelemetry(&writer);
+        genoms.fillRandom(&net);
+        genoms.calculateRatingForAll(&net, &trainingData);
+        for (int n = 0; n < 10; ++n) {
+            genoms.sort();
+            genoms.mutateAndMix(&net);
+            genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+            genoms.addPhaseSeconds(SimpleNeuralPhase::IO, 0.5);
+
+            const SimpleNeuralGenerationStats &stats = genoms.getGenerationStats();
+            if (stats.nGeneration != n + 1) {
+                std::cout << "Expected generation " << n + 1 << ", but got " << stats.nGeneration << std::endl;
+                return 1;
+            }
+            // the first generation includes the rating of all genoms
+            int nExpected = n == 0 ? 45 : 20;
+            if (stats.nEvaluations != nExpected) {
+                std::cout << "Expected " << nExpected << " evaluations, but got " << stats.nEvaluations << std::endl;
+                return 1;
+            }
+            if (!(stats.nBetterRating <= stats.nMedianRating && stats.nMedianRating <= stats.nWorstRating)) {
+                std::cout << "Expected better <= median <= worst, but got " << stats.nBetterRating
+                    << ", " << stats.nMedianRating << ", " << stats.nWorstRating << std::endl;
+                return 1;
+            }
+            if (stats.nBetterRating != genoms.getBetterRating()) {
+                std::cout << "Expected better rating " << genoms.getBetterRating() << ", but got " << stats.nBetterRating << std::endl;
+                return 1;
+            }
+            double nIO = stats.vSeconds[(int)SimpleNeuralPhase::IO];
+            if (n > 0 && !(nIO >= 0.5 && nIO < 1.0)) {
+                std::cout << "Expected I/O of the previous generation 0.5s, but got " << nIO << std::endl;
+                return 1;
+            }
+            if (!(stats.vSeconds[(int)SimpleNeuralPhase::Evaluation] > 0.0 && stats.getEvaluationsPerSecond() > 0.0)) {
+                std::cout << "Expected time of evaluation" << std::endl;
+                return 1;
+            }
+        }
+
+        std::string sText = stream.str();
+        int nExpectedLines = nFormat == 0 ? 10 : 11;
+        if (writer.getNumberOfWritten() != 10 || countLines(sText) != nExpectedLines) {
+            std::cout << "Expected " << nExpectedLines << " lines, but got " << countLines(sText) << std::endl;
+            return 1;
+        }
+        std::string sFirst = sText.substr(0, sText.find('\n'));
+        std::string sExpected = nFormat == 0 ? "{\"generation\":1,\"sort_s\":"
+            : "generation,sort_s,mutation_s,crossover_s,evaluation_s,io_s,total_s,evaluations,evaluations_per_s,better,median,worst";
+        if (sFirst.compare(0, sExpected.size(), sExpected) != 0) {
+            std::cout << "Expected line starting with " << sExpected << ", but got " << sFirst << std::endl;
+            return 1;
+        }
+    }
+
+    // rejected children (infinity) are not in the stats, JSON has no infinity
+    std::ostringstream stream;
+    SimpleNeuralTelemetryWriter writer(stream, SimpleNeuralTelemetryFormat::JsonLines);
+    SimpleNeuralGenomList genoms(5, 10, 10);
+    genoms.setRandomSeed(3);
+    genoms.setRacing(true);
+    genoms.setTelemetry(&writer);
+    genoms.fillRandom(&net);
+    genoms.calculateRatingForAll(&net, &trainingData);
+    int nRejected = 0;
+    for (int n = 0; n < 10; ++n) {
+        genoms.sort();
+        genoms.mutateAndMix(&net);
+        genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+        const SimpleNeuralGenerationStats &stats = genoms.getGenerationStats();
+        nRejected += genoms.getNumberOfRejected();
+        if (!std::isfinite(stats.nMedianRating) || !std::isfinite(stats.nWorstRating)) {
+            std::cout << "Expected finite median and worst ratings, but got " << stats.nMedianRating
+                << ", " << stats.nWorstRating << std::endl;
+            return 1;
+        }
+    }
+    if (nRejected == 0) {
+        std::cout << "Expected rejected children by racing" << std::endl;
+        return 1;
+    }
+    // children stopped by the budget have infinite ratings
+    SimpleNeuralBudget exhausted(0.0);
+    genoms.setBudget(&exhausted);
+    genoms.sort();
+    genoms.mutateAndMix(&net);
+    genoms.calculateRatingForMutatedAndMixed(&net, &trainingData);
+    genoms.setBudget(nullptr);
+    const SimpleNeuralGenerationStats &stopped = genoms.getGenerationStats();
+    if (!std::isfinite(stopped.nMedianRating) || !std::isfinite(stopped.nWorstRating)) {
+        std::cout << "Expected finite median and worst ratings of stopped generation, but got "
+            << stopped.nMedianRating << ", " << stopped.nWorstRating << std::endl;
+        return 1;
+    }
+    SimpleNeuralGenerationStats empty;
+    empty.nBetterRating = std::numeric_limits<float>::infinity();
+    empty.nMedianRating = std::numeric_limits<float>::quiet_NaN();
+    writer.write(empty);
+    std::string sText = stream.str();
+    if (sText.find("inf") != std::string::npos || sText.find("nan") != std::string::npos
+        || sText.find("\"better\":null,\"median\":null,\"worst\":0}") == std::string::npos
+    ) {
+        std::cout << "Expected null instead of not finite ratings, but got " << sText << std::endl;
+        return 1;
+    }
+    return 0;
+}